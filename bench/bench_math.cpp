@@ -0,0 +1,100 @@
+// Замеры базовой математики лабораторных: Vec3 и пересечения лучей (lab_5),
+// трансформация многоугольника applyTransformations (lab_1)
+//
+// ./bench_math [число элементов]
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../lab_1/polygon_transform.h"
+#include "../lab_5/geometry.h"
+#include "bench_timer.h"
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1 << 20;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+    std::vector<Vec3> a(count), b(count);
+    for (int i = 0; i < count; ++i) {
+        a[i] = Vec3(coordinate(random), coordinate(random), coordinate(random));
+        b[i] = Vec3(coordinate(random), coordinate(random), coordinate(random));
+    }
+    std::vector<Vec3> out(count);
+    std::printf("Элементов: %d\n", count);
+
+    // Vec3
+    printResult("Vec3::dot", measureMs([&] {
+        double sum = 0;
+        for (int i = 0; i < count; ++i)
+            sum += a[i].dot(b[i]);
+        keepResult(sum);
+    }), count, "операций");
+    printResult("Vec3::cross", measureMs([&] {
+        for (int i = 0; i < count; ++i)
+            out[i] = a[i].cross(b[i]);
+        keepResult(out);
+    }), count, "операций");
+    printResult("Vec3::normalize", measureMs([&] {
+        for (int i = 0; i < count; ++i)
+            out[i] = a[i].normalize();
+        keepResult(out);
+    }), count, "операций");
+    printResult("Vec3 a + b * 0.5 - a / 3", measureMs([&] {
+        for (int i = 0; i < count; ++i)
+            out[i] = a[i] + b[i] * 0.5 - a[i] / 3.0;
+        keepResult(out);
+    }), count, "операций");
+
+    // Пересечения: лучи из точек вокруг сцены в случайных направлениях
+    std::vector<Ray> rays;
+    rays.reserve(count);
+    for (int i = 0; i < count; ++i)
+        rays.emplace_back(Vec3(0, 1, 5) + a[i], Vec3(b[i].x, b[i].y, -1.0));
+    int hits = 0;
+    printResult("intersectSphere", measureMs([&] {
+        hits = 0;
+        for (const Ray& ray : rays) {
+            double t;
+            hits += intersectSphere(Vec3(0, 1, 0), 1.0, ray, t);
+        }
+        keepResult(hits);
+    }), count, "лучей");
+    std::printf("  попаданий: %.1f%%\n", 100.0 * hits / count);
+    printResult("intersectPlane", measureMs([&] {
+        hits = 0;
+        for (const Ray& ray : rays) {
+            double t;
+            hits += intersectPlane(Vec3(0, 0, 0), Vec3(0, 1, 0), ray, t);
+        }
+        keepResult(hits);
+    }), count, "лучей");
+    std::printf("  попаданий: %.1f%%\n", 100.0 * hits / count);
+    printResult("Ray (с нормализацией направления)", measureMs([&] {
+        for (int i = 0; i < count; ++i)
+            out[i] = Ray(a[i], b[i]).direction;
+        keepResult(out);
+    }), count, "лучей");
+
+    // applyTransformations: как в кадре лабораторной (шестиугольник) и на большом многоугольнике
+    std::vector<float> hexagon = generateHexagon(0.5f);
+    std::vector<float> transformed;
+    const int calls = std::max(1, count / 6);
+    printResult("applyTransformations, шестиугольник", measureMs([&] {
+        for (int i = 0; i < calls; ++i)
+            applyTransformations(hexagon, 0.1f, 0.2f, i * 0.001f, transformed);
+        keepResult(transformed);
+    }), calls * 6.0, "вершин");
+    std::vector<float> polygon(size_t(count) * 2);
+    for (int i = 0; i < count; ++i) {
+        polygon[i * 2] = static_cast<float>(a[i].x);
+        polygon[i * 2 + 1] = static_cast<float>(a[i].y);
+    }
+    transformed.reserve(polygon.size());
+    printResult("applyTransformations, большой многоугольник", measureMs([&] {
+        applyTransformations(polygon, 0.1f, 0.2f, 0.3f, transformed);
+        keepResult(transformed);
+    }), count, "вершин");
+    return 0;
+}
@@ -0,0 +1,49 @@
+// Замер полного кадра трассировщика лучей (lab_5) при разных разрешениях и числе потоков
+// Запускается из каталога lab_5 (текстуры wall.jpg и flour.jpg)
+//
+// ./bench_raytrace
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <omp.h>
+
+#include "../lab_5/raytracer.h"
+#include "../lab_5/trace_kernels.h"
+#include "bench_timer.h"
+
+int main() {
+    Scene scene;
+    if (!loadScene(scene)) {
+        std::cerr << "Ошибка: Не удалось загрузить текстуры (запуск из каталога lab_5)." << std::endl;
+        return -1;
+    }
+    CompiledScene compiled(scene.objects, 5);
+    std::printf("Трассировка: %s\n", compiled.describe().c_str());
+
+    const int resolutions[][2] = {{320, 240}, {800, 600}, {1920, 1080}};
+    int maxThreads = omp_get_max_threads();
+    std::vector<int> threadCounts = {1, 2, 4, maxThreads};
+    std::sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    for (const auto& resolution : resolutions) {
+        Camera camera{Vec3(0, 1, 5), resolution[0], resolution[1]};
+        std::vector<Vec3> pixels(size_t(camera.width) * camera.height);
+        for (int threads : threadCounts) {
+            omp_set_num_threads(threads);
+            double ms = measureMs([&] {
+                #pragma omp parallel for schedule(dynamic)
+                for (int y = 0; y < camera.height; ++y)
+                    for (int x = 0; x < camera.width; ++x)
+                        pixels[size_t(y) * camera.width + x] = compiled(camera.primaryRay(x + 0.5, y + 0.5));
+                keepResult(pixels);
+            });
+            std::string name = "raytracing " + std::to_string(resolution[0]) + "x" + std::to_string(resolution[1])
+                             + ", потоков: " + std::to_string(threads);
+            printResult(name, ms, double(camera.width) * camera.height, "пикселей");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+// Замер полного кадра программного растеризатора (сцена lab_2) при разных
+// разрешениях и числе потоков
+//
+// ./bench_render
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lab_2/scene_cpu.h"
+#include "bench_timer.h"
+
+int main() {
+    const int resolutions[][2] = {{320, 240}, {800, 600}, {1920, 1080}};
+
+    int maxThreads = int(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> threadCounts = {1, 2, 4, maxThreads};
+    std::sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    CpuScene scene;
+    for (const auto& resolution : resolutions) {
+        Framebuffer fb(resolution[0], resolution[1]);
+        for (int threads : threadCounts) {
+            TiledRasterizer rasterizer(fb, threads);
+            int frame = 0;
+            double ms = measureMs([&] {
+                keepResult(scene.draw(fb, rasterizer, (frame++ % 36) * 10.0f));
+            });
+            std::string name = "3dscene_cpu " + std::to_string(resolution[0]) + "x" + std::to_string(resolution[1])
+                             + ", потоков: " + std::to_string(threads);
+            printResult(name, ms, double(resolution[0]) * resolution[1], "пикселей");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+// Замер calculateTangents (lab_4) на UV-сфере при разном числе потоков
+//
+// ./bench_tangents [сегменты сферы]
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "../lab_4/mesh_preprocess.h"
+#include "bench_timer.h"
+
+int main(int argc, char** argv) {
+    int segments = argc > 1 ? std::max(1, std::atoi(argv[1])) : 512;
+
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    generateSphere(segments, 10.0f, vertices, indices);
+    std::printf("Вершин: %zu, треугольников: %zu\n", vertices.size(), indices.size() / 3);
+
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts = {1, 2, 4, maxThreads};
+    std::sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    for (unsigned threads : threadCounts) {
+        double ms = measureMs([&] {
+            calculateTangents(vertices, indices, threads);
+            keepResult(vertices);
+        });
+        printResult("calculateTangents, потоков: " + std::to_string(threads), ms, double(vertices.size()), "вершин");
+    }
+    return 0;
+}
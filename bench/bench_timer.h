@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Замер времени для программ bench_*
+// fn() выполняется повторно, пока суммарное время не превысит minSeconds (и не меньше
+// трёх раз); результат - наименьшее время одного вызова в миллисекундах.
+// Переменная окружения KG_BENCH_SECONDS задаёт minSeconds (по умолчанию 0.5).
+inline double benchSeconds() {
+    const char* value = std::getenv("KG_BENCH_SECONDS");
+    return value ? std::max(0.0, std::atof(value)) : 0.5;
+}
+
+template <typename Fn>
+double measureMs(Fn fn, double minSeconds = benchSeconds()) {
+    using Clock = std::chrono::steady_clock;
+    double best = 1e300, total = 0;
+    for (int run = 0; run < 3 || total < minSeconds * 1000.0; ++run) {
+        auto start = Clock::now();
+        fn();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        best = std::min(best, ms);
+        total += ms;
+    }
+    return best;
+}
+
+// Название, дополненное пробелами до одной ширины по числу символов UTF-8, а не байт
+inline std::string padName(const std::string& name) {
+    size_t characters = 0;
+    for (unsigned char c : name)
+        characters += (c & 0xc0) != 0x80;
+    return name + std::string(characters < 44 ? 44 - characters : 0, ' ');
+}
+
+// Строка результата: название, время и скорость в миллионах unit в секунду
+inline void printResult(const std::string& name, double ms, double items, const char* unit) {
+    std::printf("%s %10.3f мс %10.2f млн %s/с\n", padName(name).c_str(), ms, items / ms / 1000.0, unit);
+}
+
+// Строка результата для замеров чтения памяти: время и пропускная способность в ГБ/с
+inline void printBandwidth(const std::string& name, double ms, double bytes) {
+    std::printf("%s %10.3f мс %10.2f ГБ/с\n", padName(name).c_str(), ms, bytes / ms / 1e6);
+}
+
+// Не даёт компилятору выбросить вычисление результата
+template <typename T>
+inline void keepResult(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
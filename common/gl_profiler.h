@@ -0,0 +1,384 @@
+#pragma once
+
+// Профилировщик кадра для программ на OpenGL (lab_1 - lab_4)
+//
+// - процессорное время областей кода (GlProfiler::Scope / PROFILE_SCOPE);
+// - время на GPU через пары glBeginQuery/glEndQuery(GL_TIME_ELAPSED); результаты
+//   читаются с отставанием на FRAME_LATENCY кадров, поэтому конвейер не ждёт GPU;
+// - счётчики вызовов GL, вызовов отрисовки и смен состояния (макросы GL_COUNTED,
+//   GL_DRAW, GL_STATE);
+// - сводка в stdout раз в секунду и трасса в формате Chrome (chrome://tracing, Perfetto).
+//
+// Включается переменными окружения:
+//   KG_PROFILE=1            - только сводка;
+//   KG_PROFILE=trace.json   - сводка и трасса в файл;
+//   KG_PROFILE_FRAMES=N     - finished() вернёт true после N кадров (для запуска без участия человека).
+// Без запросов таймера (старый или программный драйвер) измеряется только CPU.
+//
+// С GLEW файл подключается после GL/glew.h, без него - раньше остальных заголовков OpenGL.
+#ifndef __glew_h__
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES
+#endif
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Счётчики обращений к драйверу за кадр
+struct GlCounters {
+    unsigned long calls = 0;        // Все обёрнутые вызовы
+    unsigned long drawCalls = 0;    // glDraw*, glBegin/glEnd
+    unsigned long stateChanges = 0; // Привязки, программы, uniform-переменные, матрицы
+};
+inline GlCounters glCounters;
+
+// Оборачиваемые вызовы: GL_DRAW(glDrawElements(...)); GL_STATE(glBindTexture(...));
+#define GL_COUNTED(call) (++glCounters.calls, call)
+#define GL_DRAW(call) (++glCounters.calls, ++glCounters.drawCalls, call)
+#define GL_STATE(call) (++glCounters.calls, ++glCounters.stateChanges, call)
+
+class GlProfiler {
+public:
+    // Через сколько кадров читаются результаты запросов GPU
+    static const int FRAME_LATENCY = 2;
+
+    // Создаётся после контекста OpenGL; настройки берутся из окружения
+    GlProfiler() {
+        const char* mode = std::getenv("KG_PROFILE");
+        enabled = mode && *mode && std::strcmp(mode, "0") != 0;
+        if (!enabled)
+            return;
+        size_t length = std::strlen(mode);
+        if (length > 5 && std::strcmp(mode + length - 5, ".json") == 0)
+            tracePath = mode;
+        if (const char* frames = std::getenv("KG_PROFILE_FRAMES"))
+            frameLimit = std::atol(frames);
+
+        gpuTiming = timerQuerySupported();
+        std::cout << "Профилирование: " << (gpuTiming ? "CPU и GPU" : "только CPU (нет GL_TIME_ELAPSED)")
+                  << (tracePath.empty() ? "" : ", трасса: " + tracePath) << std::endl;
+        origin = Clock::now();
+        lastSummary = origin;
+    }
+
+    ~GlProfiler() { finish(); }
+
+    // Итоговая сводка и запись трассы; вызывается до уничтожения контекста,
+    // иначе результаты GPU последних кадров теряются
+    void finish() {
+        if (!enabled || finalized)
+            return;
+        finalized = true;
+        // Без текущего контекста (окно уже закрыто) запросы GPU не читаются
+        bool contextAlive = glGetString(GL_VERSION) != nullptr;
+        // Дочитываем кадры, ещё ожидающие результатов GPU, от старого к новому
+        for (int i = 0; i < FRAME_LATENCY; ++i)
+            retire(slots[(current + 1 + i) % FRAME_LATENCY], contextAlive);
+        printSummary();
+        if (!tracePath.empty())
+            writeTrace();
+        if (contextAlive)
+            for (FrameSlot& slot : slots)
+                if (!slot.queries.empty())
+                    glDeleteQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+    }
+
+    GlProfiler(const GlProfiler&) = delete;
+    GlProfiler& operator=(const GlProfiler&) = delete;
+
+    bool isEnabled() const { return enabled; }
+
+    // Достигнут ли предел KG_PROFILE_FRAMES
+    bool finished() const { return enabled && frameLimit > 0 && frameCount >= frameLimit; }
+
+    void beginFrame() {
+        if (!enabled || finalized)
+            return;
+        current = (current + 1) % FRAME_LATENCY;
+        FrameSlot& slot = slots[current];
+        retire(slot); // Запросы этого слота выданы FRAME_LATENCY кадров назад
+        slot.start = now();
+        slot.events.clear();
+        slot.usedQueries = 0;
+        glCounters = GlCounters();
+        depth = 0;
+        gpuScopeOpen = false;
+        frameOpen = true;
+    }
+
+    void endFrame() {
+        if (!enabled || !frameOpen)
+            return;
+        FrameSlot& slot = slots[current];
+        slot.duration = now() - slot.start;
+        slot.counters = glCounters;
+        slot.complete = true;
+        frameOpen = false;
+        ++frameCount;
+
+        if (std::chrono::duration<double>(Clock::now() - lastSummary).count() >= 1.0) {
+            printSummary();
+            lastSummary = Clock::now();
+        }
+    }
+
+    // Измеряемая область; на GPU измеряются только области, не вложенные в другую
+    // измеряемую на GPU (запросы GL_TIME_ELAPSED не могут быть вложенными)
+    class Scope {
+    public:
+        Scope(GlProfiler& profiler, const char* name) : profiler(profiler), index(profiler.open(name)) {}
+        ~Scope() { profiler.close(index); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GlProfiler& profiler;
+        int index;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Event {
+        const char* name;
+        int depth;
+        double start;    // мкс от запуска
+        double duration; // мкс
+        int query;       // Индекс запроса в слоте или -1
+        double gpu;      // мкс, -1 если не измерялось
+    };
+
+    // Данные одного кадра, ожидающего результатов GPU
+    struct FrameSlot {
+        double start = 0, duration = 0;
+        GlCounters counters;
+        std::vector<Event> events;
+        std::vector<GLuint> queries;
+        size_t usedQueries = 0;
+        bool complete = false;
+    };
+
+    // Накопленная статистика для сводки
+    struct Totals {
+        long count = 0, gpuCount = 0;
+        double cpu = 0, gpu = 0;
+    };
+
+    struct TraceEvent {
+        const char* name;
+        int track; // 1 - CPU, 2 - GPU
+        double start, duration;
+    };
+
+    struct TraceCounter {
+        double time;
+        GlCounters counters;
+    };
+
+    static bool timerQuerySupported() {
+        const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+        int major = 0, minor = 0;
+        if (version && std::sscanf(version, "%d.%d", &major, &minor) == 2 && (major > 3 || (major == 3 && minor >= 3)))
+            return true;
+        const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+        return extensions && std::strstr(extensions, "GL_ARB_timer_query");
+    }
+
+    double now() const {
+        return std::chrono::duration<double, std::micro>(Clock::now() - origin).count();
+    }
+
+    int open(const char* name) {
+        if (!enabled || !frameOpen)
+            return -1;
+        FrameSlot& slot = slots[current];
+        Event event = {name, depth++, now(), 0, -1, -1};
+        if (gpuTiming && !gpuScopeOpen) {
+            if (slot.usedQueries == slot.queries.size()) {
+                slot.queries.push_back(0);
+                glGenQueries(1, &slot.queries.back());
+            }
+            event.query = static_cast<int>(slot.usedQueries++);
+            glBeginQuery(GL_TIME_ELAPSED, slot.queries[event.query]);
+            gpuScopeOpen = true;
+        }
+        slot.events.push_back(event);
+        return static_cast<int>(slot.events.size()) - 1;
+    }
+
+    void close(int index) {
+        if (index < 0 || !frameOpen)
+            return;
+        Event& event = slots[current].events[index];
+        if (event.query >= 0) {
+            glEndQuery(GL_TIME_ELAPSED);
+            gpuScopeOpen = false;
+        }
+        event.duration = now() - event.start;
+        --depth;
+    }
+
+    // Сбор результатов кадра: в сводку и трассу
+    void retire(FrameSlot& slot, bool readGpu = true) {
+        if (!slot.complete)
+            return;
+        slot.complete = false;
+        // Первый кадр - прогрев: у некоторых драйверов (llvmpipe) первый запрос
+        // с реальной работой возвращает мусор, время GPU этого кадра не учитывается
+        readGpu = readGpu && retiredFrames++ > 0;
+
+        double frameGpu = 0;
+        bool hasGpu = false;
+        for (Event& event : slot.events) {
+            if (event.query >= 0 && readGpu) {
+                GLuint query = slot.queries[event.query];
+                GLint available = 0;
+                glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available)
+                    ++stalls; // Результата ещё нет - ждём его (ожидание учитывается в сводке)
+                GLuint64 nanoseconds = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+                event.gpu = nanoseconds / 1000.0;
+                frameGpu += event.gpu;
+                hasGpu = true;
+            }
+
+            Totals& totals = scopeTotals[event.name];
+            ++totals.count;
+            totals.cpu += event.duration;
+            if (event.gpu >= 0) {
+                ++totals.gpuCount;
+                totals.gpu += event.gpu;
+            }
+
+            if (!tracePath.empty()) {
+                trace.push_back({event.name, 1, event.start, event.duration});
+                // Время выполнения на GPU неизвестно - событие ставится в начало области на CPU
+                if (event.gpu >= 0)
+                    trace.push_back({event.name, 2, event.start, event.gpu});
+            }
+        }
+
+        ++frameTotals.count;
+        frameTotals.cpu += slot.duration;
+        if (hasGpu) {
+            ++frameTotals.gpuCount;
+            frameTotals.gpu += frameGpu;
+        }
+        counterTotals.calls += slot.counters.calls;
+        counterTotals.drawCalls += slot.counters.drawCalls;
+        counterTotals.stateChanges += slot.counters.stateChanges;
+
+        if (!tracePath.empty()) {
+            trace.push_back({"Кадр", 1, slot.start, slot.duration});
+            counters.push_back({slot.start, slot.counters});
+        }
+    }
+
+    // Средние значения с прошлой сводки
+    void printSummary() {
+        if (frameTotals.count == 0)
+            return;
+        double frames = static_cast<double>(frameTotals.count);
+        std::printf("Кадр: CPU %.3f мс", frameTotals.cpu / frames / 1000.0);
+        if (frameTotals.gpuCount > 0)
+            std::printf(", GPU %.3f мс", frameTotals.gpu / frameTotals.gpuCount / 1000.0);
+        std::printf(", вызовов GL %.0f, отрисовки %.0f, смен состояния %.0f",
+                    counterTotals.calls / frames, counterTotals.drawCalls / frames, counterTotals.stateChanges / frames);
+        if (stalls > 0)
+            std::printf(", ожиданий GPU %ld", stalls);
+        std::printf("\n");
+        for (const auto& [name, totals] : scopeTotals) {
+            // Выравнивание по числу символов, а не байт UTF-8
+            int symbols = 0;
+            for (char c : name)
+                symbols += (c & 0xC0) != 0x80;
+            std::printf("  %s%*s CPU %.3f мс", name.c_str(), std::max(24 - symbols, 0), "", totals.cpu / frames / 1000.0);
+            if (totals.gpuCount > 0)
+                std::printf(", GPU %.3f мс", totals.gpu / std::max(frameTotals.gpuCount, 1L) / 1000.0);
+            std::printf(" (%.1f раз за кадр)\n", totals.count / frames);
+        }
+        std::fflush(stdout);
+
+        frameTotals = Totals();
+        counterTotals = GlCounters();
+        scopeTotals.clear();
+        stalls = 0;
+    }
+
+    static void writeEscaped(std::ostream& out, const char* text) {
+        for (; *text; ++text) {
+            if (*text == '"' || *text == '\\')
+                out << '\\';
+            out << *text;
+        }
+    }
+
+    // Формат Trace Event: события "X" с длительностью и счётчики "C"
+    void writeTrace() {
+        std::ofstream out(tracePath);
+        if (!out) {
+            std::cerr << "Не удалось сохранить трассу: " << tracePath << std::endl;
+            return;
+        }
+        out << "{\"traceEvents\":[\n"
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+        char number[64];
+        for (const TraceEvent& event : trace) {
+            out << ",\n{\"name\":\"";
+            writeEscaped(out, event.name);
+            std::snprintf(number, sizeof(number), "%.3f,\"dur\":%.3f", event.start, event.duration);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.track << ",\"ts\":" << number << "}";
+        }
+        for (const TraceCounter& counter : counters) {
+            std::snprintf(number, sizeof(number), "%.3f", counter.time);
+            out << ",\n{\"name\":\"GL\",\"ph\":\"C\",\"pid\":1,\"ts\":" << number
+                << ",\"args\":{\"calls\":" << counter.counters.calls
+                << ",\"draws\":" << counter.counters.drawCalls
+                << ",\"state\":" << counter.counters.stateChanges << "}}";
+        }
+        out << "\n]}\n";
+        std::cout << "Трасса сохранена: " << tracePath << std::endl;
+    }
+
+    bool enabled = false;
+    bool finalized = false;
+    bool gpuTiming = false;
+    std::string tracePath;
+    long frameLimit = 0;
+    long frameCount = 0;
+    long retiredFrames = 0;
+
+    Clock::time_point origin, lastSummary;
+    FrameSlot slots[FRAME_LATENCY];
+    int current = 0;
+    int depth = 0;
+    bool frameOpen = false;
+    bool gpuScopeOpen = false;
+
+    Totals frameTotals;
+    GlCounters counterTotals;
+    std::map<std::string, Totals> scopeTotals;
+    long stalls = 0;
+
+    std::vector<TraceEvent> trace;
+    std::vector<TraceCounter> counters;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+// Измерение до конца текущего блока: PROFILE_SCOPE(profiler, "Отрисовка");
+#define PROFILE_SCOPE(profiler, name) GlProfiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(profiler, name)
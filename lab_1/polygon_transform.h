@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+// Построение и трансформация многоугольника лабораторной 1
+// Без OpenGL: используется программой polygon_animation и замерами производительности
+
+const float PI = 3.14159265359f;
+
+// Генерация шестиугольника
+inline std::vector<float> generateHexagon(float radius) {
+    std::vector<float> vertices;
+    for (int i = 0; i < 6; ++i) {
+        float angle = 2 * PI * i / 6;
+        vertices.push_back(radius * cos(angle));
+        vertices.push_back(radius * sin(angle));
+    }
+    return vertices;
+}
+
+// Применение матриц трансформации
+inline void applyTransformations(const std::vector<float>& vertices, float dx, float dy, float angle, std::vector<float>& transformedVertices) {
+    float cosA = cos(angle);
+    float sinA = sin(angle);
+    transformedVertices.clear();
+    for (size_t i = 0; i < vertices.size(); i += 2) {
+        float x = vertices[i];
+        float y = vertices[i + 1];
+
+        // Поворот и перемещение
+        float rotatedX = x * cosA - y * sinA;
+        float rotatedY = x * sinA + y * cosA;
+        transformedVertices.push_back(rotatedX + dx);
+        transformedVertices.push_back(rotatedY + dy);
+    }
+}
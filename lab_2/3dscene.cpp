@@ -1,14 +1,19 @@
+#include "mesh_cache.h" // Должен подключаться до остальных заголовков OpenGL
+#include "../common/gl_profiler.h"
 #include <SFML/Window.hpp>
 #include <SFML/OpenGL.hpp>
 #include <GL/glu.h>
 #include <cmath>
+#include <vector>
+
+#include "mat4.h"
 
 // Углы вращения камеры и дистанция до сцены
 float cameraAngleX = 0.0f, cameraAngleY = 0.0f, cameraDistance = 5.0f;
 
 // Функция для отрисовки куба
 void drawCube() {
-    glBegin(GL_QUADS); // Начало отрисовки квадратных граней
+    GL_DRAW(glBegin(GL_QUADS)); // Начало отрисовки квадратных граней
 
     // Задняя грань (оранжевая)
     glColor3f(1, 0.5, 0);
@@ -57,7 +62,7 @@ void drawCube() {
 
 // Функция для отрисовки пирамиды
 void drawPyramid() {
-    glBegin(GL_TRIANGLES); // Отрисовка треугольных граней
+    GL_DRAW(glBegin(GL_TRIANGLES)); // Отрисовка треугольных граней
 
     // Грань 1 (красная)
     glColor3f(1, 0, 0); 
@@ -85,7 +90,7 @@ void drawPyramid() {
 
     glEnd(); // Завершение отрисовки треугольников
 
-    glBegin(GL_QUADS); // Основание пирамиды
+    GL_DRAW(glBegin(GL_QUADS)); // Основание пирамиды
     glColor3f(0, 1, 1); // Основание (голубое)
     glVertex3f(-1, -1, 1);
     glVertex3f(1, -1, 1);
@@ -94,12 +99,33 @@ void drawPyramid() {
     glEnd();
 }
 
-// Функция для отрисовки сферы
-void drawSphere() {
-    GLUquadric *quad = gluNewQuadric(); // Создание квадрики для сферы
+// Параметры проекции (те же, что в gluPerspective)
+const float fovY = 45.0f;
+
+// Отрисовка сфер (экземпляров единичной сферы из кэша LOD)
+// Уровень детализации выбирается по размеру сферы на экране; сферы одного уровня
+// объединены в batch, так что на кадр приходится не больше одного вызова отрисовки на уровень.
+void drawSpheres(LodBatch& batch, const LodMeshCache& cache, const std::vector<MeshInstance>& spheres,
+                 float viewportHeight) {
+    Mat4 view = Mat4::translate(0, 0, -cameraDistance) * Mat4::rotate(cameraAngleX, 1, 0, 0)
+              * Mat4::rotate(cameraAngleY, 0, 1, 0);
+
+    std::vector<std::vector<MeshInstance>> byLod(cache.lodCount());
+    for (const MeshInstance& s : spheres) {
+        Vec4 eye = view.transform(s.x, s.y, s.z);
+        float distance = std::sqrt(eye.x * eye.x + eye.y * eye.y + eye.z * eye.z);
+        byLod[cache.selectLod(projectedRadius(s.scale, distance, fovY, viewportHeight))].push_back(s);
+    }
+
     glColor3f(1.0, 0.4, 0.7); // Розовый цвет сферы
-    gluSphere(quad, 1.0, 32, 32); // Радиус = 1.0, 32 сегмента по широте и долготе
-    gluDeleteQuadric(quad); // Удаление квадрики
+    for (size_t lod = 0; lod < byLod.size(); ++lod) {
+        batch.update(lod, byLod[lod]);
+        if (batch.empty(lod))
+            continue;
+        GL_STATE(batch.bind(lod));
+        GL_DRAW(batch.draw(lod));
+    }
+    LodBatch::unbind();
 }
 
 // Установка камеры для просмотра сцены
@@ -117,12 +143,31 @@ int main() {
 
     glEnable(GL_DEPTH_TEST); // Включение теста глубины для 3D-отрисовки
     glMatrixMode(GL_PROJECTION); // Установка режима проекционной матрицы
-    gluPerspective(45.0, 800.0 / 600.0, 1.0, 100.0); // Перспективная проекция
+    gluPerspective(fovY, 800.0 / 600.0, 1.0, 100.0); // Перспективная проекция
 
     glMatrixMode(GL_MODELVIEW); // Установка режима модельно-видовой матрицы
 
+    // Единичная сфера тесселируется один раз на нескольких уровнях детализации
+    LodMeshCache sphereCache({8, 16, 32, 64, 128}, [](int segments) {
+        return sphereMesh(1.0f, segments, segments);
+    });
+
+    // Основная сфера сцены и сетка 20x20 маленьких сфер (масштаб единичной сферы - радиус)
+    const std::vector<MeshInstance> mainSphere = {{0.0f, 0.0f, -2.0f, 1.0f}};
+    std::vector<MeshInstance> sphereField;
+    for (int i = 0; i < 20; ++i)
+        for (int j = 0; j < 20; ++j)
+            sphereField.push_back({(i - 9.5f) * 1.5f, -3.0f, (j - 9.5f) * 1.5f, 0.4f});
+    bool showSphereField = false;
+    LodBatch mainSphereBatch(sphereCache), sphereFieldBatch(sphereCache);
+
+    // Профилирование кадра (включается переменной окружения KG_PROFILE)
+    GlProfiler profiler;
+
     // Главный цикл приложения
     while (window.isOpen()) {
+        profiler.beginFrame();
+
         sf::Event event;
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed) // Обработка закрытия окна
@@ -138,32 +183,52 @@ int main() {
                 // Приближение/удаление камеры
                 if (event.key.code == sf::Keyboard::Equal) cameraDistance -= 0.5; // Приближение
                 if (event.key.code == sf::Keyboard::Hyphen) cameraDistance += 0.5; // Удаление
+
+                // Сетка из 400 сфер
+                if (event.key.code == sf::Keyboard::G) showSphereField = !showSphereField;
             }
         }
 
         // Очистка экрана и буфера глубины
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        GL_COUNTED(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
         setupCamera(); // Установка камеры
 
-        // Отрисовка куба
-        glPushMatrix();
-        glTranslatef(-2.0, 0.0, 0.0); // Перемещение куба влево
-        drawCube();
-        glPopMatrix();
-
-        // Отрисовка пирамиды
-        glPushMatrix();
-        glTranslatef(2.0, 0.0, 0.0); // Перемещение пирамиды вправо
-        drawPyramid();
-        glPopMatrix();
-
-        // Отрисовка сферы
-        glPushMatrix();
-        glTranslatef(0.0, 0.0, -2.0); // Перемещение сферы назад
-        drawSphere();
-        glPopMatrix();
-
-        window.display(); // Отображение содержимого окна
+        {
+            PROFILE_SCOPE(profiler, "Куб и пирамида");
+
+            // Отрисовка куба
+            glPushMatrix();
+            GL_STATE(glTranslatef(-2.0, 0.0, 0.0)); // Перемещение куба влево
+            drawCube();
+            glPopMatrix();
+
+            // Отрисовка пирамиды
+            glPushMatrix();
+            GL_STATE(glTranslatef(2.0, 0.0, 0.0)); // Перемещение пирамиды вправо
+            drawPyramid();
+            glPopMatrix();
+        }
+
+        // Отрисовка сферы (и сетки сфер, если она включена)
+        {
+            PROFILE_SCOPE(profiler, "Сферы");
+            float viewportHeight = static_cast<float>(window.getSize().y);
+            drawSpheres(mainSphereBatch, sphereCache, mainSphere, viewportHeight);
+            if (showSphereField)
+                drawSpheres(sphereFieldBatch, sphereCache, sphereField, viewportHeight);
+        }
+
+        {
+            PROFILE_SCOPE(profiler, "Показ кадра");
+            window.display(); // Отображение содержимого окна
+        }
+        profiler.endFrame();
+
+        // Запуск без участия человека: KG_PROFILE_FRAMES кадров
+        if (profiler.finished()) {
+            profiler.finish();
+            window.close();
+        }
     }
 
     return 0;
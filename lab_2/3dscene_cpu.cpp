@@ -0,0 +1,39 @@
+// Сцена из 3dscene.cpp (куб, пирамида, сфера), отрисованная программным растеризатором
+// Работает без окна и GPU: кадры рендерятся в память, последний сохраняется в PPM.
+//
+// ./3dscene_cpu [ширина высота кадры потоки файл.ppm]
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "scene_cpu.h"
+
+int main(int argc, char** argv) {
+    int width = argc > 1 ? std::atoi(argv[1]) : 800;
+    int height = argc > 2 ? std::atoi(argv[2]) : 600;
+    int frames = argc > 3 ? std::atoi(argv[3]) : 100;
+    int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+    std::string output = argc > 5 ? argv[5] : "3dscene_cpu.ppm";
+
+    CpuScene scene;
+    Framebuffer fb(width, height);
+    TiledRasterizer rasterizer(fb, threads);
+    size_t triangles = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame)
+        triangles += scene.draw(fb, rasterizer, frame * 360.0f / std::max(frames, 1));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << width << "x" << height << ", кадров: " << frames << ", время: " << seconds * 1000.0 << " мс\n"
+              << "Кадров в секунду: " << frames / seconds << "\n"
+              << "Треугольников в секунду: " << triangles / seconds << std::endl;
+
+    if (!fb.writePPM(output)) {
+        std::cerr << "Не удалось сохранить изображение: " << output << std::endl;
+        return -1;
+    }
+    return 0;
+}
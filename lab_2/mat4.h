@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cmath>
+
+// Вектор из четырёх компонент (однородные координаты)
+struct Vec4 {
+    float x, y, z, w;
+};
+
+// Матрица 4x4 в том же порядке хранения, что и в OpenGL (по столбцам)
+// Фабричные функции повторяют glTranslatef, glRotatef, glScalef, glFrustum и gluPerspective,
+// поэтому сцены можно описывать так же, как в коде с фиксированным конвейером.
+struct Mat4 {
+    float m[16];
+
+    static Mat4 identity() {
+        Mat4 r = {};
+        r.m[0] = r.m[5] = r.m[10] = r.m[15] = 1.0f;
+        return r;
+    }
+
+    static Mat4 translate(float x, float y, float z) {
+        Mat4 r = identity();
+        r.m[12] = x;
+        r.m[13] = y;
+        r.m[14] = z;
+        return r;
+    }
+
+    static Mat4 scale(float x, float y, float z) {
+        Mat4 r = identity();
+        r.m[0] = x;
+        r.m[5] = y;
+        r.m[10] = z;
+        return r;
+    }
+
+    // Поворот на angle градусов вокруг оси (x, y, z), как glRotatef
+    static Mat4 rotate(float angle, float x, float y, float z) {
+        float len = std::sqrt(x * x + y * y + z * z);
+        x /= len;
+        y /= len;
+        z /= len;
+        float rad = angle * 3.14159265358979f / 180.0f;
+        float c = std::cos(rad), s = std::sin(rad), t = 1.0f - c;
+
+        Mat4 r = identity();
+        r.m[0] = x * x * t + c;     r.m[4] = x * y * t - z * s; r.m[8] = x * z * t + y * s;
+        r.m[1] = y * x * t + z * s; r.m[5] = y * y * t + c;     r.m[9] = y * z * t - x * s;
+        r.m[2] = z * x * t - y * s; r.m[6] = z * y * t + x * s; r.m[10] = z * z * t + c;
+        return r;
+    }
+
+    static Mat4 frustum(float left, float right, float bottom, float top, float zNear, float zFar) {
+        Mat4 r = {};
+        r.m[0] = 2.0f * zNear / (right - left);
+        r.m[5] = 2.0f * zNear / (top - bottom);
+        r.m[8] = (right + left) / (right - left);
+        r.m[9] = (top + bottom) / (top - bottom);
+        r.m[10] = -(zFar + zNear) / (zFar - zNear);
+        r.m[11] = -1.0f;
+        r.m[14] = -2.0f * zFar * zNear / (zFar - zNear);
+        return r;
+    }
+
+    static Mat4 perspective(float fovY, float aspect, float zNear, float zFar) {
+        float fH = std::tan(fovY / 360.0f * 3.14159265358979f) * zNear;
+        float fW = fH * aspect;
+        return frustum(-fW, fW, -fH, fH, zNear, zFar);
+    }
+
+    Mat4 operator*(const Mat4& b) const {
+        Mat4 r;
+        for (int col = 0; col < 4; ++col)
+            for (int row = 0; row < 4; ++row)
+                r.m[col * 4 + row] = m[row] * b.m[col * 4] + m[4 + row] * b.m[col * 4 + 1]
+                                   + m[8 + row] * b.m[col * 4 + 2] + m[12 + row] * b.m[col * 4 + 3];
+        return r;
+    }
+
+    // Преобразование точки (w = 1)
+    Vec4 transform(float x, float y, float z) const {
+        return {m[0] * x + m[4] * y + m[8] * z + m[12],
+                m[1] * x + m[5] * y + m[9] * z + m[13],
+                m[2] * x + m[6] * y + m[10] * z + m[14],
+                m[3] * x + m[7] * y + m[11] * z + m[15]};
+    }
+};
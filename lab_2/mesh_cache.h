@@ -0,0 +1,159 @@
+#pragma once
+
+// Функции буферов (OpenGL 1.5) объявляются только с GL_GLEXT_PROTOTYPES,
+// поэтому файл должен подключаться раньше остальных заголовков OpenGL
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES
+#endif
+#include <SFML/OpenGL.hpp>
+#include <GL/glext.h>
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "parametric_mesh.h"
+
+// Меш с несколькими уровнями детализации (LOD)
+// Каждый уровень тесселируется один раз при создании и хранится на CPU:
+// вершины экземпляров объединяются в общие буферы GPU (см. LodBatch).
+class LodMeshCache {
+public:
+    // levels - число сегментов каждого уровня по возрастанию, generate(segments) строит меш
+    LodMeshCache(const std::vector<int>& levels, const std::function<IndexedMesh(int)>& generate) {
+        for (int segments : levels)
+            lods.push_back({segments, generate(segments)});
+    }
+
+    size_t lodCount() const { return lods.size(); }
+    int segments(size_t lod) const { return lods[lod].segments; }
+    const IndexedMesh& mesh(size_t lod) const { return lods[lod].mesh; }
+
+    // Выбор уровня по радиусу объекта на экране в пикселях:
+    // самый грубый уровень, у которого сегмент контура не длиннее maxSegmentPixels
+    size_t selectLod(float projectedRadius, float maxSegmentPixels = 6.0f) const {
+        const float circumference = 2.0f * 3.14159265359f * projectedRadius;
+        for (size_t i = 0; i < lods.size(); ++i)
+            if (circumference / lods[i].segments <= maxSegmentPixels)
+                return i;
+        return lods.size() - 1;
+    }
+
+private:
+    struct Lod {
+        int segments;
+        IndexedMesh mesh;
+    };
+    std::vector<Lod> lods;
+};
+
+// Экземпляр меша: перенос в (x, y, z) и равномерный масштаб (нормали не меняются)
+struct MeshInstance {
+    float x, y, z, scale;
+
+    bool operator==(const MeshInstance& other) const {
+        return x == other.x && y == other.y && z == other.z && scale == other.scale;
+    }
+};
+
+// Экземпляры меша, объединённые по уровням детализации
+// Вершины всех экземпляров одного уровня заранее переносятся и масштабируются на CPU
+// и лежат в одном буфере GPU, поэтому уровень рисуется одним glDrawElements.
+// Буферы уровня пересобираются, только когда меняется состав его группы (камера
+// перевела экземпляр на другой уровень или изменились сами экземпляры).
+class LodBatch {
+public:
+    explicit LodBatch(const LodMeshCache& cache) : cache(cache), groups(cache.lodCount()) {}
+
+    ~LodBatch() {
+        for (Group& group : groups) {
+            glDeleteBuffers(1, &group.vbo);
+            glDeleteBuffers(1, &group.ibo);
+        }
+    }
+
+    LodBatch(const LodBatch&) = delete;
+    LodBatch& operator=(const LodBatch&) = delete;
+
+    // Экземпляры уровня lod на этот кадр (буферы не трогаются, если состав не изменился)
+    void update(size_t lod, const std::vector<MeshInstance>& instances) {
+        Group& group = groups[lod];
+        if (group.vbo != 0 && instances == group.instances)
+            return;
+        group.instances = instances;
+        group.indexCount = 0;
+        if (instances.empty())
+            return;
+
+        const IndexedMesh& mesh = cache.mesh(lod);
+        const size_t vertexCount = mesh.vertices.size() / IndexedMesh::STRIDE;
+        std::vector<float> vertices;
+        std::vector<unsigned> indices;
+        vertices.reserve(mesh.vertices.size() * instances.size());
+        indices.reserve(mesh.indices.size() * instances.size());
+        for (const MeshInstance& instance : instances) {
+            const unsigned base = static_cast<unsigned>(vertices.size() / IndexedMesh::STRIDE);
+            for (size_t v = 0; v < vertexCount; ++v) {
+                const float* source = &mesh.vertices[v * IndexedMesh::STRIDE];
+                vertices.insert(vertices.end(), {source[0] * instance.scale + instance.x,
+                                                 source[1] * instance.scale + instance.y,
+                                                 source[2] * instance.scale + instance.z,
+                                                 source[3], source[4], source[5]});
+            }
+            for (unsigned index : mesh.indices)
+                indices.push_back(base + index);
+        }
+
+        if (group.vbo == 0) {
+            glGenBuffers(1, &group.vbo);
+            glGenBuffers(1, &group.ibo);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, group.vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, group.ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned), indices.data(), GL_DYNAMIC_DRAW);
+        group.indexCount = static_cast<GLsizei>(indices.size());
+    }
+
+    bool empty(size_t lod) const { return groups[lod].indexCount == 0; }
+
+    // Привязка буферов уровня
+    void bind(size_t lod) const {
+        const GLsizei stride = IndexedMesh::STRIDE * sizeof(float);
+        glBindBuffer(GL_ARRAY_BUFFER, groups[lod].vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, groups[lod].ibo);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glVertexPointer(3, GL_FLOAT, stride, (void*)0);
+        glNormalPointer(GL_FLOAT, stride, (void*)(3 * sizeof(float)));
+    }
+
+    // Отрисовка всех экземпляров привязанного уровня с текущей матрицей
+    void draw(size_t lod) const {
+        glDrawElements(GL_TRIANGLES, groups[lod].indexCount, GL_UNSIGNED_INT, (void*)0);
+    }
+
+    static void unbind() {
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glDisableClientState(GL_NORMAL_ARRAY);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+private:
+    struct Group {
+        std::vector<MeshInstance> instances;
+        GLuint vbo = 0, ibo = 0;
+        GLsizei indexCount = 0;
+    };
+    const LodMeshCache& cache;
+    std::vector<Group> groups;
+};
+
+// Радиус сферы на экране в пикселях по расстоянию до камеры и вертикальному углу обзора (в градусах)
+inline float projectedRadius(float radius, float distance, float fovY, float viewportHeight) {
+    if (distance <= radius)
+        return viewportHeight; // Камера внутри или вплотную - максимальная детализация
+    float halfFov = fovY * 0.5f * 3.14159265359f / 180.0f;
+    return radius * viewportHeight * 0.5f / (distance * std::tan(halfFov));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+// Индексированный меш параметрической поверхности
+// vertices: x, y, z, nx, ny, nz подряд для каждой вершины
+struct IndexedMesh {
+    std::vector<float> vertices;
+    std::vector<unsigned> indices;
+
+    static const int STRIDE = 6; // Число float на вершину
+};
+
+// Тесселяция поверхности surface(u, v, position, normal), u и v в [0, 1],
+// сеткой slices x stacks (вершины на шве дублируются)
+template <typename Surface>
+IndexedMesh tessellate(int slices, int stacks, Surface surface) {
+    IndexedMesh mesh;
+    mesh.vertices.reserve(size_t(slices + 1) * (stacks + 1) * IndexedMesh::STRIDE);
+    mesh.indices.reserve(size_t(slices) * stacks * 6);
+
+    for (int i = 0; i <= stacks; ++i) {
+        for (int j = 0; j <= slices; ++j) {
+            float position[3], normal[3];
+            surface(float(j) / slices, float(i) / stacks, position, normal);
+            mesh.vertices.insert(mesh.vertices.end(), position, position + 3);
+            mesh.vertices.insert(mesh.vertices.end(), normal, normal + 3);
+        }
+    }
+
+    for (int i = 0; i < stacks; ++i) {
+        for (int j = 0; j < slices; ++j) {
+            unsigned a = i * (slices + 1) + j;
+            unsigned b = a + slices + 1;
+            mesh.indices.insert(mesh.indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+    return mesh;
+}
+
+// Сфера с той же ориентацией, что gluSphere: ось вдоль Z, v = 0 на полюсе +Z
+inline IndexedMesh sphereMesh(float radius, int slices, int stacks) {
+    const float PI = 3.14159265359f;
+    return tessellate(slices, stacks, [radius, PI](float u, float v, float* position, float* normal) {
+        float theta = v * PI;
+        float phi = u * 2.0f * PI;
+        normal[0] = std::sin(theta) * std::cos(phi);
+        normal[1] = std::sin(theta) * std::sin(phi);
+        normal[2] = std::cos(theta);
+        for (int k = 0; k < 3; ++k)
+            position[k] = normal[k] * radius;
+    });
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+// Сцена из 3dscene.cpp (куб, пирамида, сфера) для программного растеризатора
+// Используется программой 3dscene_cpu, замерами производительности и эталонными тестами
+
+#include "parametric_mesh.h"
+#include "softrast.h"
+
+// Куб с теми же гранями и цветами, что в drawCube()
+inline Mesh buildCube() {
+    const float v[8][3] = {
+        {-1, -1, -1}, {-1, 1, -1}, {1, 1, -1}, {1, -1, -1},
+        {-1, -1, 1}, {-1, 1, 1}, {1, 1, 1}, {1, -1, 1},
+    };
+    Mesh mesh;
+    mesh.addQuad(packColor(1, 0.5f, 0), v[0], v[1], v[2], v[3]); // Задняя грань (оранжевая)
+    mesh.addQuad(packColor(0, 1, 0), v[4], v[5], v[6], v[7]);    // Передняя грань (зеленая)
+    mesh.addQuad(packColor(0, 0, 1), v[0], v[4], v[5], v[1]);    // Левая грань (синяя)
+    mesh.addQuad(packColor(1, 1, 0), v[3], v[7], v[6], v[2]);    // Правая грань (желтая)
+    mesh.addQuad(packColor(0.5f, 0, 0.5f), v[0], v[3], v[7], v[4]); // Нижняя грань (фиолетовая)
+    mesh.addQuad(packColor(0, 1, 1), v[1], v[2], v[6], v[5]);    // Верхняя грань (голубая)
+    return mesh;
+}
+
+// Пирамида с теми же гранями и цветами, что в drawPyramid()
+inline Mesh buildPyramid() {
+    const float top[3] = {0, 1, 0};
+    const float a[3] = {-1, -1, 1}, b[3] = {1, -1, 1}, c[3] = {1, -1, -1}, d[3] = {-1, -1, -1};
+    Mesh mesh;
+    mesh.addTriangle(packColor(1, 0, 0), top, a, b); // Грань 1 (красная)
+    mesh.addTriangle(packColor(0, 1, 0), top, b, c); // Грань 2 (зеленая)
+    mesh.addTriangle(packColor(0, 0, 1), top, c, d); // Грань 3 (синяя)
+    mesh.addTriangle(packColor(1, 1, 0), top, d, a); // Грань 4 (желтая)
+    mesh.addQuad(packColor(0, 1, 1), a, b, c, d);    // Основание (голубое)
+    return mesh;
+}
+
+// Сфера как gluSphere(quad, radius, slices, stacks): ось вдоль Z
+inline Mesh buildSphere(float radius, int slices, int stacks, uint32_t color) {
+    IndexedMesh sphere = sphereMesh(radius, slices, stacks);
+    Mesh mesh;
+    for (size_t i = 0; i < sphere.indices.size(); i += 3) {
+        const float* a = &sphere.vertices[sphere.indices[i] * IndexedMesh::STRIDE];
+        const float* b = &sphere.vertices[sphere.indices[i + 1] * IndexedMesh::STRIDE];
+        const float* c = &sphere.vertices[sphere.indices[i + 2] * IndexedMesh::STRIDE];
+        mesh.addTriangle(color, a, b, c);
+    }
+    return mesh;
+}
+
+// Меши сцены и отрисовка кадра
+struct CpuScene {
+    Mesh cube = buildCube();
+    Mesh pyramid = buildPyramid();
+    Mesh sphere = buildSphere(1.0f, 32, 32, packColor(1.0f, 0.4f, 0.7f)); // Розовый цвет сферы
+
+    // Кадр с камерой setupCamera() из 3dscene.cpp: углы в градусах и расстояние до сцены
+    // По умолчанию - начальная камера 3dscene.cpp (cameraAngleX = 0, cameraDistance = 5)
+    // Возвращает число треугольников кадра
+    size_t draw(Framebuffer& fb, TiledRasterizer& rasterizer, float cameraAngleY,
+                float cameraAngleX = 0.0f, float cameraDistance = 5.0f) const {
+        Mat4 projection = Mat4::perspective(45.0f, float(fb.width) / fb.height, 1.0f, 100.0f);
+        Mat4 view = Mat4::translate(0, 0, -cameraDistance) * Mat4::rotate(cameraAngleX, 1, 0, 0)
+                  * Mat4::rotate(cameraAngleY, 0, 1, 0);
+        Mat4 viewProjection = projection * view;
+
+        fb.clear(packColor(0, 0, 0));
+        rasterizer.draw(cube, viewProjection * Mat4::translate(-2.0f, 0.0f, 0.0f));
+        rasterizer.draw(pyramid, viewProjection * Mat4::translate(2.0f, 0.0f, 0.0f));
+        rasterizer.draw(sphere, viewProjection * Mat4::translate(0.0f, 0.0f, -2.0f));
+        rasterizer.flush();
+        return rasterizer.lastTriangleCount();
+    }
+};
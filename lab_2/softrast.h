@@ -0,0 +1,349 @@
+#pragma once
+
+// Программный растеризатор для машин без GPU
+// Треугольники распределяются по экранным тайлам (binning), после чего тайлы
+// растеризуются параллельно (OpenMP) с вычислением рёберных функций сразу для
+// четырёх пикселей (SSE2) и тестом глубины GL_LESS. Все вершины грани имеют
+// один цвет, как при glColor3f перед glBegin в исходных сценах.
+// Пиксели на общем ребре и в общей вершине закрашиваются ровно одним треугольником
+// (правило верхнего левого ребра). Вершины привязываются к сетке 1/256 пикселя, а умножение
+// и сложение в рёберных функциях не должны сливаться в FMA: при сборке с -march=native
+// и т.п. нужен -ffp-contract=off.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "mat4.h"
+
+// Упаковка цвета в RGBA8 (как glColor3f, компоненты от 0 до 1)
+inline uint32_t packColor(float r, float g, float b) {
+    auto to8 = [](float c) { return static_cast<uint32_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return to8(r) | (to8(g) << 8) | (to8(b) << 16) | 0xff000000u;
+}
+
+// Треугольник модели с цветом грани
+struct ColoredTriangle {
+    float v[3][3];
+    uint32_t color;
+};
+
+// Набор треугольников, заполняемый так же, как glBegin/glVertex3f
+struct Mesh {
+    std::vector<ColoredTriangle> triangles;
+
+    void addTriangle(uint32_t color, const float a[3], const float b[3], const float c[3]) {
+        ColoredTriangle t;
+        for (int i = 0; i < 3; ++i) {
+            t.v[0][i] = a[i];
+            t.v[1][i] = b[i];
+            t.v[2][i] = c[i];
+        }
+        t.color = color;
+        triangles.push_back(t);
+    }
+
+    // Четырёхугольник из GL_QUADS разбивается веером на два треугольника
+    void addQuad(uint32_t color, const float a[3], const float b[3], const float c[3], const float d[3]) {
+        addTriangle(color, a, b, c);
+        addTriangle(color, a, c, d);
+    }
+};
+
+// Буфер кадра: цвет RGBA8 и глубина в диапазоне [0, 1]
+// Ширина строки выровнена на 4 пикселя для векторной записи
+struct Framebuffer {
+    int width, height, stride;
+    std::vector<uint32_t> color;
+    std::vector<float> depth;
+
+    Framebuffer(int w, int h) : width(w), height(h), stride((w + 3) & ~3),
+        color(size_t(stride) * h), depth(size_t(stride) * h) {}
+
+    void clear(uint32_t clearColor) {
+        std::fill(color.begin(), color.end(), clearColor);
+        std::fill(depth.begin(), depth.end(), 1.0f);
+    }
+
+    uint32_t pixel(int x, int y) const {
+        return color[size_t(y) * stride + x];
+    }
+
+    // Сохранение в формате PPM (P6)
+    bool writePPM(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        file << "P6\n" << width << " " << height << "\n255\n";
+        std::vector<char> row(size_t(width) * 3);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                uint32_t c = pixel(x, y);
+                row[x * 3] = static_cast<char>(c & 0xff);
+                row[x * 3 + 1] = static_cast<char>((c >> 8) & 0xff);
+                row[x * 3 + 2] = static_cast<char>((c >> 16) & 0xff);
+            }
+            file.write(row.data(), row.size());
+        }
+        return bool(file);
+    }
+};
+
+// Тайловый растеризатор
+// draw() преобразует и распределяет треугольники по тайлам, flush() растеризует кадр
+class TiledRasterizer {
+public:
+    static const int TILE_SIZE = 64; // Кратен 4 для векторной обработки строки
+
+    explicit TiledRasterizer(Framebuffer& fb, int threads = 0) : fb(fb), threads(threads) {
+        tilesX = (fb.width + TILE_SIZE - 1) / TILE_SIZE;
+        tilesY = (fb.height + TILE_SIZE - 1) / TILE_SIZE;
+        bins.resize(size_t(tilesX) * tilesY);
+    }
+
+    // Число потоков растеризации (0 - по умолчанию OpenMP)
+    void setThreads(int n) { threads = n; }
+
+    // Преобразование меша матрицей MVP, отсечение по ближней плоскости и распределение по тайлам
+    void draw(const Mesh& mesh, const Mat4& mvp) {
+        for (const ColoredTriangle& t : mesh.triangles) {
+            Vec4 clip[3];
+            for (int i = 0; i < 3; ++i)
+                clip[i] = mvp.transform(t.v[i][0], t.v[i][1], t.v[i][2]);
+            clipAndSetup(clip, t.color);
+        }
+    }
+
+    // Растеризация всех тайлов и очистка очередей
+    void flush() {
+        const int tileCount = tilesX * tilesY;
+#ifdef _OPENMP
+        int threadCount = threads > 0 ? threads : omp_get_max_threads();
+        #pragma omp parallel for schedule(dynamic) num_threads(threadCount)
+#endif
+        for (int tile = 0; tile < tileCount; ++tile)
+            rasterizeTile(tile);
+
+        rasterizedTriangles = triangles.size();
+        triangles.clear();
+        for (auto& bin : bins)
+            bin.clear();
+    }
+
+    // Число треугольников (после отсечения), растеризованных последним flush()
+    size_t lastTriangleCount() const { return rasterizedTriangles; }
+
+private:
+    struct ScreenTriangle {
+        float x[3], y[3], z[3];
+        int minX, minY, maxX, maxY; // Ограничивающий прямоугольник в пикселях (включительно)
+        uint32_t color;
+    };
+
+    // Привязка экранной координаты к сетке 1/256 пикселя (как субпиксельная точность GPU)
+    static float snapSubpixel(float v) {
+        return std::nearbyint(v * 256.0f) * (1.0f / 256.0f);
+    }
+
+    // Отсечение по ближней плоскости (z >= -w) алгоритмом Сазерленда-Ходжмена
+    void clipAndSetup(const Vec4 clip[3], uint32_t color) {
+        const float eps = 1e-5f;
+        bool allInside = true;
+        for (int i = 0; i < 3; ++i)
+            allInside = allInside && clip[i].z >= -clip[i].w && clip[i].w > eps;
+        if (allInside) {
+            setup(clip[0], clip[1], clip[2], color);
+            return;
+        }
+
+        Vec4 poly[4];
+        int count = 0;
+        for (int i = 0; i < 3; ++i) {
+            const Vec4& a = clip[i];
+            const Vec4& b = clip[(i + 1) % 3];
+            float da = a.z + a.w;
+            float db = b.z + b.w;
+            if (da >= 0.0f)
+                poly[count++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                float t = da / (da - db);
+                poly[count++] = {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+                                 a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t};
+            }
+        }
+        for (int i = 1; i + 1 < count; ++i)
+            setup(poly[0], poly[i], poly[i + 1], color);
+    }
+
+    // Перевод в экранные координаты и распределение по тайлам
+    void setup(const Vec4& a, const Vec4& b, const Vec4& c, uint32_t color) {
+        ScreenTriangle t;
+        const Vec4* v[3] = {&a, &b, &c};
+        for (int i = 0; i < 3; ++i) {
+            if (v[i]->w <= 1e-5f)
+                return;
+            float invW = 1.0f / v[i]->w;
+            t.x[i] = snapSubpixel((v[i]->x * invW * 0.5f + 0.5f) * fb.width);
+            t.y[i] = snapSubpixel((0.5f - v[i]->y * invW * 0.5f) * fb.height); // Строка 0 - верх изображения
+            t.z[i] = v[i]->z * invW * 0.5f + 0.5f;
+        }
+
+        // Положительная ориентация (отсечение задних граней не выполняется, как в исходных сценах)
+        float area = (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]) - (t.y[2] - t.y[0]) * (t.x[1] - t.x[0]);
+        if (std::abs(area) < 1e-8f)
+            return;
+        if (area < 0.0f) {
+            std::swap(t.x[1], t.x[2]);
+            std::swap(t.y[1], t.y[2]);
+            std::swap(t.z[1], t.z[2]);
+        }
+
+        // Пиксели, центры которых могут попасть в треугольник
+        float minX = std::min({t.x[0], t.x[1], t.x[2]}), maxX = std::max({t.x[0], t.x[1], t.x[2]});
+        float minY = std::min({t.y[0], t.y[1], t.y[2]}), maxY = std::max({t.y[0], t.y[1], t.y[2]});
+        // (ограничение до приведения к int защищает от переполнения у вершин далеко за экраном)
+        const float w = static_cast<float>(fb.width), h = static_cast<float>(fb.height);
+        t.minX = static_cast<int>(std::clamp(std::ceil(minX - 0.5f), 0.0f, w));
+        t.minY = static_cast<int>(std::clamp(std::ceil(minY - 0.5f), 0.0f, h));
+        t.maxX = static_cast<int>(std::clamp(std::floor(maxX - 0.5f), -1.0f, w - 1.0f));
+        t.maxY = static_cast<int>(std::clamp(std::floor(maxY - 0.5f), -1.0f, h - 1.0f));
+        if (t.minX > t.maxX || t.minY > t.maxY)
+            return;
+        t.color = color;
+
+        uint32_t index = static_cast<uint32_t>(triangles.size());
+        triangles.push_back(t);
+        for (int ty = t.minY / TILE_SIZE; ty <= t.maxY / TILE_SIZE; ++ty)
+            for (int tx = t.minX / TILE_SIZE; tx <= t.maxX / TILE_SIZE; ++tx)
+                bins[size_t(ty) * tilesX + tx].push_back(index);
+    }
+
+    // Растеризация одного тайла; треугольники обрабатываются в порядке отправки
+    void rasterizeTile(int tile) {
+        const int tileX0 = (tile % tilesX) * TILE_SIZE;
+        const int tileY0 = (tile / tilesX) * TILE_SIZE;
+        const int tileX1 = std::min(tileX0 + TILE_SIZE, fb.stride) - 1;
+        const int tileY1 = std::min(tileY0 + TILE_SIZE, fb.height) - 1;
+
+        for (uint32_t index : bins[tile]) {
+            const ScreenTriangle& t = triangles[index];
+            int x0 = std::max(t.minX, tileX0) & ~3; // Начало строки выровнено на 4 пикселя
+            int x1 = std::min(t.maxX, tileX1);
+            int y0 = std::max(t.minY, tileY0);
+            int y1 = std::min(t.maxY, tileY1);
+            if (x0 > x1 || y0 > y1)
+                continue;
+
+            // Рёберные функции E_i(p) = A_i * (p.x - X_i) + B_i * (p.y - Y_i) для ребра, противолежащего вершине i
+            // (X_i, Y_i) - меньшая (по y, затем по x) вершина ребра; знак A_i, B_i задаёт ориентацию:
+            // у двух треугольников с общим ребром E отличается ровно знаком, без разницы в округлении,
+            // а в вершинах ребра E в точности равна нулю.
+            // Правило верхнего левого ребра: на левых и верхних рёбрах пиксель принимается при E >= 0,
+            // на остальных - при E > 0 (порог на 1 ulp выше нуля), поэтому пиксель на общем ребре
+            // закрашивает ровно один треугольник независимо от порядка отрисовки.
+            float A[3], B[3], X[3], Y[3], bias[3];
+            for (int i = 0; i < 3; ++i) {
+                int j = (i + 1) % 3, k = (i + 2) % 3;
+                bool swapped = t.y[k] < t.y[j] || (t.y[k] == t.y[j] && t.x[k] < t.x[j]);
+                int a = swapped ? k : j, b = swapped ? j : k;
+                A[i] = t.y[b] - t.y[a];
+                B[i] = t.x[a] - t.x[b];
+                X[i] = t.x[a];
+                Y[i] = t.y[a];
+                if (swapped) {
+                    A[i] = -A[i];
+                    B[i] = -B[i];
+                }
+                bool topLeft = A[i] > 0.0f || (A[i] == 0.0f && B[i] > 0.0f);
+                bias[i] = topLeft ? 0.0f : std::numeric_limits<float>::denorm_min();
+            }
+            float area = A[0] * (t.x[0] - X[0]) + B[0] * (t.y[0] - Y[0]);
+            float dz1 = (t.z[1] - t.z[0]) / area;
+            float dz2 = (t.z[2] - t.z[0]) / area;
+
+            for (int y = y0; y <= y1; ++y) {
+                // E считается в каждом пикселе из точных разностей p - (X_i, Y_i), а не накоплением E,
+                // чтобы совпадать у соседних треугольников
+                float py = y + 0.5f;
+                float r0 = B[0] * (py - Y[0]);
+                float r1 = B[1] * (py - Y[1]);
+                float r2 = B[2] * (py - Y[2]);
+                uint32_t* colorRow = fb.color.data() + size_t(y) * fb.stride;
+                float* depthRow = fb.depth.data() + size_t(y) * fb.stride;
+
+#if defined(__SSE2__)
+                const __m128 lane = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+                const __m128 A0 = _mm_set1_ps(A[0]), A1 = _mm_set1_ps(A[1]), A2 = _mm_set1_ps(A[2]);
+                const __m128 X0 = _mm_set1_ps(X[0]), X1 = _mm_set1_ps(X[1]), X2 = _mm_set1_ps(X[2]);
+                const __m128 R0 = _mm_set1_ps(r0), R1 = _mm_set1_ps(r1), R2 = _mm_set1_ps(r2);
+                const __m128 BIAS0 = _mm_set1_ps(bias[0]), BIAS1 = _mm_set1_ps(bias[1]), BIAS2 = _mm_set1_ps(bias[2]);
+                const __m128 Z0 = _mm_set1_ps(t.z[0]);
+                const __m128 DZ1 = _mm_set1_ps(dz1);
+                const __m128 DZ2 = _mm_set1_ps(dz2);
+                const __m128i colorVec = _mm_set1_epi32(static_cast<int>(t.color));
+
+                // p.x - X_i точно (координаты на сетке 1/256 пикселя), поэтому его можно наращивать
+                __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x0)), lane);
+                __m128 DX0 = _mm_sub_ps(px, X0), DX1 = _mm_sub_ps(px, X1), DX2 = _mm_sub_ps(px, X2);
+                const __m128 four = _mm_set1_ps(4.0f);
+
+                for (int x = x0; x <= x1; x += 4) {
+                    __m128 E0 = _mm_add_ps(_mm_mul_ps(A0, DX0), R0);
+                    __m128 E1 = _mm_add_ps(_mm_mul_ps(A1, DX1), R1);
+                    __m128 E2 = _mm_add_ps(_mm_mul_ps(A2, DX2), R2);
+                    DX0 = _mm_add_ps(DX0, four);
+                    DX1 = _mm_add_ps(DX1, four);
+                    DX2 = _mm_add_ps(DX2, four);
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(E0, BIAS0), _mm_cmpge_ps(E1, BIAS1)),
+                                               _mm_cmpge_ps(E2, BIAS2));
+                    if (_mm_movemask_ps(inside)) {
+                        __m128 z = _mm_add_ps(Z0, _mm_add_ps(_mm_mul_ps(E1, DZ1), _mm_mul_ps(E2, DZ2)));
+                        __m128 oldDepth = _mm_loadu_ps(depthRow + x);
+                        __m128 mask = _mm_and_ps(inside, _mm_cmplt_ps(z, oldDepth));
+                        if (_mm_movemask_ps(mask)) {
+                            _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(mask, z), _mm_andnot_ps(mask, oldDepth)));
+                            __m128i imask = _mm_castps_si128(mask);
+                            __m128i oldColor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colorRow + x));
+                            _mm_storeu_si128(reinterpret_cast<__m128i*>(colorRow + x),
+                                             _mm_or_si128(_mm_and_si128(imask, colorVec), _mm_andnot_si128(imask, oldColor)));
+                        }
+                    }
+                }
+#else
+                for (int x = x0; x <= x1; ++x) {
+                    float px = x + 0.5f;
+                    float e0 = A[0] * (px - X[0]) + r0;
+                    float e1 = A[1] * (px - X[1]) + r1;
+                    float e2 = A[2] * (px - X[2]) + r2;
+                    if (e0 >= bias[0] && e1 >= bias[1] && e2 >= bias[2]) {
+                        float z = t.z[0] + e1 * dz1 + e2 * dz2;
+                        if (z < depthRow[x]) {
+                            depthRow[x] = z;
+                            colorRow[x] = t.color;
+                        }
+                    }
+                }
+#endif
+            }
+        }
+    }
+
+    Framebuffer& fb;
+    int threads;
+    int tilesX, tilesY;
+    std::vector<ScreenTriangle> triangles;
+    std::vector<std::vector<uint32_t>> bins;
+    size_t rasterizedTriangles = 0;
+};
@@ -0,0 +1,414 @@
+#include "../common/gl_profiler.h" // Должен подключаться до остальных заголовков OpenGL
+#include <SFML/Window.hpp>
+#include <SFML/OpenGL.hpp>
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <random>
+#include <string>
+#include <cstdlib>
+#include <cmath> // Для функций tan и M_PI
+
+#include "culling.h"
+#include "scene_graph.h"
+
+// Структура для хранения трансформаций объекта
+struct Transform {
+    sf::Vector3f position; // Позиция объекта
+    sf::Vector3f rotation; // Углы поворота объекта
+    sf::Vector3f scale;    // Масштаб объекта
+
+    Transform() : position(0, 0, 0), rotation(0, 0, 0), scale(1, 1, 1) {}
+
+    // Локальная матрица: та же последовательность, что glTranslatef/glRotatef/glScalef
+    Mat4 matrix() const {
+        return Mat4::translate(position.x, position.y, position.z)
+             * Mat4::rotate(rotation.x, 1, 0, 0)
+             * Mat4::rotate(rotation.y, 0, 1, 0)
+             * Mat4::rotate(rotation.z, 0, 0, 1)
+             * Mat4::scale(scale.x, scale.y, scale.z);
+    }
+
+    bool operator!=(const Transform& other) const {
+        return position != other.position || rotation != other.rotation || scale != other.scale;
+    }
+};
+
+// Базовый класс для объектов сцены
+class SceneObject {
+public:
+    Transform transform; // Трансформация относительно родителя
+
+    virtual ~SceneObject() = default;
+    virtual void draw(const Mat4& world) = 0; // Виртуальная функция отрисовки с мировой матрицей
+    virtual float localRadius() const = 0; // Радиус ограничивающей сферы вокруг начала координат объекта
+
+    // Ограничивающая сфера в мировых координатах (поворот на неё не влияет)
+    void worldBounds(const Mat4& world, float center[3], float& radius) const {
+        const float* m = world.m;
+        center[0] = m[12];
+        center[1] = m[13];
+        center[2] = m[14];
+        // Наибольшее растяжение - длина самого длинного столбца 3x3
+        float maxScale2 = 0;
+        for (int c = 0; c < 3; ++c)
+            maxScale2 = std::max(maxScale2, m[c * 4] * m[c * 4] + m[c * 4 + 1] * m[c * 4 + 1] + m[c * 4 + 2] * m[c * 4 + 2]);
+        radius = localRadius() * std::sqrt(maxScale2);
+    }
+};
+
+// Класс куба
+class Cube : public SceneObject {
+public:
+    float localRadius() const override { return std::sqrt(3.0f); } // Вершины (±1, ±1, ±1)
+
+    void draw(const Mat4& world) override {
+        glPushMatrix();
+        // Применение трансформаций (мировая матрица посчитана в SceneGraph)
+        GL_STATE(glMultMatrixf(world.m));
+
+        // Отрисовка куба
+        GL_DRAW(glBegin(GL_QUADS));
+
+        glColor3f(1, 0, 0); // Красный
+        glVertex3f(-1, -1, -1);
+        glVertex3f(1, -1, -1);
+        glVertex3f(1, 1, -1);
+        glVertex3f(-1, 1, -1);
+
+        glColor3f(0, 1, 0); // Зеленый
+        glVertex3f(-1, -1, 1);
+        glVertex3f(1, -1, 1);
+        glVertex3f(1, 1, 1);
+        glVertex3f(-1, 1, 1);
+
+        glColor3f(0, 0, 1); // Синий
+        glVertex3f(-1, -1, -1);
+        glVertex3f(-1, -1, 1);
+        glVertex3f(-1, 1, 1);
+        glVertex3f(-1, 1, -1);
+
+        glColor3f(1, 1, 0); // Желтый
+        glVertex3f(1, -1, -1);
+        glVertex3f(1, -1, 1);
+        glVertex3f(1, 1, 1);
+        glVertex3f(1, 1, -1);
+
+        glColor3f(1, 0, 1); // Фиолетовый
+        glVertex3f(-1, -1, -1);
+        glVertex3f(1, -1, -1);
+        glVertex3f(1, -1, 1);
+        glVertex3f(-1, -1, 1);
+
+        glColor3f(0, 1, 1); // Голубой
+        glVertex3f(-1, 1, -1);
+        glVertex3f(1, 1, -1);
+        glVertex3f(1, 1, 1);
+        glVertex3f(-1, 1, 1);
+
+        glEnd();
+
+        glPopMatrix();
+    }
+};
+
+// Класс пирамиды
+class Pyramid : public SceneObject {
+public:
+    float localRadius() const override { return std::sqrt(3.0f); } // Вершины основания (±1, -1, ±1)
+
+    void draw(const Mat4& world) override {
+        glPushMatrix();
+        // Применение трансформаций (мировая матрица посчитана в SceneGraph)
+        GL_STATE(glMultMatrixf(world.m));
+
+        // Отрисовка пирамиды
+        GL_DRAW(glBegin(GL_TRIANGLES));
+
+        glColor3f(1, 0, 0); // Красная грань
+        glVertex3f(0, 1, 0);
+        glVertex3f(-1, -1, 1);
+        glVertex3f(1, -1, 1);
+
+        glColor3f(0, 1, 0); // Зеленая грань
+        glVertex3f(0, 1, 0);
+        glVertex3f(1, -1, 1);
+        glVertex3f(1, -1, -1);
+
+        glColor3f(0, 0, 1); // Синяя грань
+        glVertex3f(0, 1, 0);
+        glVertex3f(1, -1, -1);
+        glVertex3f(-1, -1, -1);
+
+        glColor3f(1, 1, 0); // Желтая грань
+        glVertex3f(0, 1, 0);
+        glVertex3f(-1, -1, -1);
+        glVertex3f(-1, -1, 1);
+
+        glEnd();
+
+        GL_DRAW(glBegin(GL_QUADS)); // Основание пирамиды
+        glColor3f(0, 1, 1);
+        glVertex3f(-1, -1, 1);
+        glVertex3f(1, -1, 1);
+        glVertex3f(1, -1, -1);
+        glVertex3f(-1, -1, -1);
+        glEnd();
+
+        glPopMatrix();
+    }
+};
+
+// Обновление объекта в сетке отсечения
+void updateBounds(UniformGrid& grid, uint32_t id, const SceneObject& object, const Mat4& world) {
+    float center[3], radius;
+    object.worldBounds(world, center, radius);
+    grid.update(id, center, radius);
+}
+
+int main(int argc, char** argv) {
+    // Число дополнительных случайных объектов: ./3dtransformation --objects 100000
+    int extraObjectCount = 0;
+    for (int i = 1; i + 1 < argc; ++i)
+        if (std::string(argv[i]) == "--objects")
+            extraObjectCount = std::atoi(argv[i + 1]);
+
+    // Создание окна с настройками OpenGL
+    sf::Window window(sf::VideoMode(800, 600), "3D Трансформации: Куб и Пирамида", sf::Style::Default, sf::ContextSettings(24));
+    window.setFramerateLimit(60);
+
+    // Инициализация OpenGL
+    glEnable(GL_DEPTH_TEST); // Включение буфера глубины
+
+    // Настройка перспективы с использованием glFrustum
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    float aspect = 800.0f / 600.0f;
+    float fovY = 45.0f;
+    float zNear = 0.1f;
+    float zFar = 100.0f;
+    float fH = tan(fovY / 360.0f * M_PI) * zNear;
+    float fW = fH * aspect;
+    glFrustum(-fW, fW, -fH, fH, zNear, zFar);
+    glMatrixMode(GL_MODELVIEW);
+
+    // Создание объектов сцены
+    Cube cube;
+    cube.transform.position = sf::Vector3f(-2, 0, 0);
+
+    Pyramid pyramid;
+    pyramid.transform.position = sf::Vector3f(2, 0, 0);
+
+    std::vector<SceneObject*> objects = { &cube, &pyramid };
+
+    // Иерархия трансформаций: узел i соответствует objects[i]
+    SceneGraph graph;
+    graph.addNode(-1, cube.transform.matrix());
+    graph.addNode(-1, pyramid.transform.matrix());
+
+    // Дополнительные объекты, разбросанные вокруг для проверки отсечения:
+    // деревья глубиной до 5, дети смещены относительно родителя
+    std::vector<std::unique_ptr<SceneObject>> extraObjects;
+    std::vector<int> branch; // Путь от корня текущего дерева до последнего узла
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> spread(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> height(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+    std::uniform_real_distribution<float> size(0.5f, 2.0f);
+    std::uniform_real_distribution<float> offset(-4.0f, 4.0f);
+    std::uniform_int_distribution<int> ascend(0, 2);
+    for (int i = 0; i < extraObjectCount; ++i) {
+        std::unique_ptr<SceneObject> object;
+        if (i % 2 == 0)
+            object.reset(new Cube());
+        else
+            object.reset(new Pyramid());
+        // Подъём на случайное число уровней; новый корень, если путь закончился
+        for (int up = ascend(rng); up > 0 && !branch.empty(); --up)
+            branch.pop_back();
+        if (branch.size() >= 5)
+            branch.pop_back();
+        int parent = branch.empty() ? -1 : branch.back();
+        if (parent < 0) {
+            object->transform.position = sf::Vector3f(spread(rng), height(rng), spread(rng));
+            object->transform.scale *= size(rng);
+        } else {
+            object->transform.position = sf::Vector3f(offset(rng), offset(rng), offset(rng));
+        }
+        object->transform.rotation = sf::Vector3f(angle(rng), angle(rng), angle(rng));
+        branch.push_back(graph.addNode(parent, object->transform.matrix()));
+        objects.push_back(object.get());
+        extraObjects.push_back(std::move(object));
+    }
+
+    // Сетка для отсечения невидимых объектов
+    UniformGrid grid(16.0f);
+    for (size_t i = 0; i < objects.size(); ++i)
+        updateBounds(grid, static_cast<uint32_t>(i), *objects[i], graph.world(static_cast<int>(i)));
+    std::vector<uint32_t> visible;
+    visible.reserve(objects.size());
+    bool cullingEnabled = true;
+
+    // Матрица проекции на CPU (та же, что у glFrustum выше) для построения пирамиды видимости
+    Mat4 projection = Mat4::frustum(-fW, fW, -fH, fH, zNear, zFar);
+
+    // Параметры камеры
+    sf::Vector3f cameraPosition(0, 0, 10);
+    sf::Vector2f cameraRotation(0, 0);  // Поворот камеры по осям
+
+    // Индекс текущего объекта
+    int currentObjectIndex = 0;
+
+    // Профилирование кадра (включается переменной окружения KG_PROFILE)
+    GlProfiler profiler;
+
+    while (window.isOpen()) {
+        profiler.beginFrame();
+
+        // Обработка событий
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed)
+                window.close();
+            // Выход по клавише Esc
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)
+                window.close();
+            // Включение/выключение отсечения
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F)
+                cullingEnabled = !cullingEnabled;
+        }
+
+        // Управление камерой
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
+            cameraPosition.z -= 0.1f; // Камера вперед
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down))
+            cameraPosition.z += 0.1f; // Камера назад
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+            cameraPosition.x -= 0.1f; // Камера влево
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+            cameraPosition.x += 0.1f; // Камера вправо
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Equal))
+            cameraPosition.y += 0.1f; // Камера вверх
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Hyphen))
+            cameraPosition.y -= 0.1f; // Камера вниз
+
+        // Поворот камеры
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Z))
+            cameraRotation.x += 1.0f;  // Поворот камеры по оси X
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::X))
+            cameraRotation.x -= 1.0f;  // Поворот камеры по оси X
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::C))
+            cameraRotation.y += 1.0f;  // Поворот камеры по оси Y
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::V))
+            cameraRotation.y -= 1.0f;  // Поворот камеры по оси Y
+
+        // Переключение между объектами
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num1))
+            currentObjectIndex = 0; // Переключение на куб
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num2))
+            currentObjectIndex = 1; // Переключение на пирамиду
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num3) && objects.size() > 2)
+            currentObjectIndex = 2; // Переключение на первое дерево дополнительных объектов
+
+        // Управление текущим объектом
+        SceneObject* currentObject = objects[currentObjectIndex];
+        Transform previousTransform = currentObject->transform;
+
+        // Перемещение объекта
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::W))
+            currentObject->transform.position.z -= 0.1f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::S))
+            currentObject->transform.position.z += 0.1f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::A))
+            currentObject->transform.position.x -= 0.1f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::D))
+            currentObject->transform.position.x += 0.1f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Q))
+            currentObject->transform.position.y += 0.1f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::E))
+            currentObject->transform.position.y -= 0.1f;
+
+        // Поворот объекта
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::I))
+            currentObject->transform.rotation.x += 1.0f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::K))
+            currentObject->transform.rotation.x -= 1.0f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::J))
+            currentObject->transform.rotation.y += 1.0f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::L))
+            currentObject->transform.rotation.y -= 1.0f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::U))
+            currentObject->transform.rotation.z += 1.0f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::O))
+            currentObject->transform.rotation.z -= 1.0f;
+
+        // Масштабирование объекта
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::N))
+            currentObject->transform.scale *= 1.01f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::M))
+            currentObject->transform.scale *= 0.99f;
+
+        // Изменяться может только текущий объект - пересчитывается только его поддерево
+        if (currentObject->transform != previousTransform)
+            graph.setLocal(currentObjectIndex, currentObject->transform.matrix());
+        size_t updatedNodes;
+        {
+            PROFILE_SCOPE(profiler, "Граф сцены");
+            updatedNodes = graph.update([&](int id) {
+                updateBounds(grid, static_cast<uint32_t>(id), *objects[id], graph.world(id));
+            });
+        }
+
+        // Очистка экрана
+        GL_COUNTED(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+        // Установка камеры
+        glLoadIdentity();
+        glRotatef(cameraRotation.x, 1, 0, 0);  // Поворот камеры по оси X
+        glRotatef(cameraRotation.y, 0, 1, 0);  // Поворот камеры по оси Y
+        glTranslatef(-cameraPosition.x, -cameraPosition.y, -cameraPosition.z);
+
+        // Пирамида видимости той же камеры
+        Mat4 view = Mat4::rotate(cameraRotation.x, 1, 0, 0) * Mat4::rotate(cameraRotation.y, 0, 1, 0)
+                  * Mat4::translate(-cameraPosition.x, -cameraPosition.y, -cameraPosition.z);
+        Frustum frustum = Frustum::fromMatrix(projection * view);
+
+        // Отрисовка только видимых объектов
+        visible.clear();
+        {
+            PROFILE_SCOPE(profiler, "Отсечение");
+            if (cullingEnabled) {
+                grid.query(frustum, [&visible](uint32_t id) { visible.push_back(id); });
+            } else {
+                for (size_t i = 0; i < objects.size(); ++i)
+                    visible.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        {
+            PROFILE_SCOPE(profiler, "Отрисовка");
+            for (uint32_t id : visible)
+                objects[id]->draw(graph.world(static_cast<int>(id)));
+        }
+
+        // Статистика отсечения за кадр
+        window.setTitle("Отрисовано: " + std::to_string(visible.size()) +
+                        ", отсечено: " + std::to_string(objects.size() - visible.size()) +
+                        (cullingEnabled ? "" : " (отсечение выключено)") +
+                        ", пересчитано узлов: " + std::to_string(updatedNodes));
+
+        // Отображение
+        {
+            PROFILE_SCOPE(profiler, "Показ кадра");
+            window.display();
+        }
+        profiler.endFrame();
+
+        // Запуск без участия человека: KG_PROFILE_FRAMES кадров
+        if (profiler.finished()) {
+            profiler.finish();
+            window.close();
+        }
+    }
+
+    return 0;
+}
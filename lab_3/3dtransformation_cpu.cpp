@@ -0,0 +1,107 @@
+// Сцена из 3dtransformation (куб и пирамида с трансформациями), отрисованная
+// программным растеризатором из lab_2. Работает без окна и GPU.
+//
+// ./3dtransformation_cpu [ширина высота кадры потоки файл.ppm]
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "../lab_2/softrast.h"
+
+// Позиция, углы поворота (в градусах) и масштаб объекта, как в Transform
+struct CpuTransform {
+    float position[3] = {0, 0, 0};
+    float rotation[3] = {0, 0, 0};
+    float scale[3] = {1, 1, 1};
+
+    // Та же последовательность, что glTranslatef/glRotatef/glScalef в SceneObject::draw()
+    Mat4 matrix() const {
+        return Mat4::translate(position[0], position[1], position[2])
+             * Mat4::rotate(rotation[0], 1, 0, 0)
+             * Mat4::rotate(rotation[1], 0, 1, 0)
+             * Mat4::rotate(rotation[2], 0, 0, 1)
+             * Mat4::scale(scale[0], scale[1], scale[2]);
+    }
+};
+
+// Куб с теми же гранями и цветами, что в Cube::draw()
+Mesh buildCube() {
+    const float v[8][3] = {
+        {-1, -1, -1}, {1, -1, -1}, {1, 1, -1}, {-1, 1, -1},
+        {-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1},
+    };
+    Mesh mesh;
+    mesh.addQuad(packColor(1, 0, 0), v[0], v[1], v[2], v[3]); // Красный
+    mesh.addQuad(packColor(0, 1, 0), v[4], v[5], v[6], v[7]); // Зеленый
+    mesh.addQuad(packColor(0, 0, 1), v[0], v[4], v[7], v[3]); // Синий
+    mesh.addQuad(packColor(1, 1, 0), v[1], v[5], v[6], v[2]); // Желтый
+    mesh.addQuad(packColor(1, 0, 1), v[0], v[1], v[5], v[4]); // Фиолетовый
+    mesh.addQuad(packColor(0, 1, 1), v[3], v[2], v[6], v[7]); // Голубой
+    return mesh;
+}
+
+// Пирамида с теми же гранями и цветами, что в Pyramid::draw()
+Mesh buildPyramid() {
+    const float top[3] = {0, 1, 0};
+    const float a[3] = {-1, -1, 1}, b[3] = {1, -1, 1}, c[3] = {1, -1, -1}, d[3] = {-1, -1, -1};
+    Mesh mesh;
+    mesh.addTriangle(packColor(1, 0, 0), top, a, b); // Красная грань
+    mesh.addTriangle(packColor(0, 1, 0), top, b, c); // Зеленая грань
+    mesh.addTriangle(packColor(0, 0, 1), top, c, d); // Синяя грань
+    mesh.addTriangle(packColor(1, 1, 0), top, d, a); // Желтая грань
+    mesh.addQuad(packColor(0, 1, 1), a, b, c, d);    // Основание
+    return mesh;
+}
+
+int main(int argc, char** argv) {
+    int width = argc > 1 ? std::atoi(argv[1]) : 800;
+    int height = argc > 2 ? std::atoi(argv[2]) : 600;
+    int frames = argc > 3 ? std::atoi(argv[3]) : 100;
+    int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+    std::string output = argc > 5 ? argv[5] : "3dtransformation_cpu.ppm";
+
+    Mesh cubeMesh = buildCube();
+    Mesh pyramidMesh = buildPyramid();
+
+    CpuTransform cube, pyramid;
+    cube.position[0] = -2;
+    pyramid.position[0] = 2;
+
+    // Перспектива, как glFrustum в 3dtransformation
+    float aspect = float(width) / height;
+    Mat4 projection = Mat4::perspective(45.0f, aspect, 0.1f, 100.0f);
+
+    // Камера (0, 0, 10) без поворота
+    Mat4 view = Mat4::translate(0, 0, -10);
+    Mat4 viewProjection = projection * view;
+
+    Framebuffer fb(width, height);
+    TiledRasterizer rasterizer(fb, threads);
+    size_t triangles = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        // Объекты вращаются, как при удержании клавиш I/J/U
+        cube.rotation[0] = cube.rotation[1] = frame * 1.0f;
+        pyramid.rotation[1] = pyramid.rotation[2] = frame * 1.0f;
+
+        fb.clear(packColor(0, 0, 0));
+        rasterizer.draw(cubeMesh, viewProjection * cube.matrix());
+        rasterizer.draw(pyramidMesh, viewProjection * pyramid.matrix());
+        rasterizer.flush();
+        triangles += rasterizer.lastTriangleCount();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << width << "x" << height << ", кадров: " << frames << ", время: " << seconds * 1000.0 << " мс\n"
+              << "Кадров в секунду: " << frames / seconds << "\n"
+              << "Треугольников в секунду: " << triangles / seconds << std::endl;
+
+    if (!fb.writePPM(output)) {
+        std::cerr << "Не удалось сохранить изображение: " << output << std::endl;
+        return -1;
+    }
+    return 0;
+}
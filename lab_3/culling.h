@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "../lab_2/mat4.h"
+
+// Пирамида видимости: шесть плоскостей a*x + b*y + c*z + d >= 0 для точек внутри
+struct Frustum {
+    float planes[6][4];
+
+    // Извлечение плоскостей из матрицы projection * view (метод Грибба-Хартманна)
+    static Frustum fromMatrix(const Mat4& viewProjection) {
+        const float* m = viewProjection.m;
+        // Строка i матрицы, хранящейся по столбцам
+        auto row = [m](int i, float out[4]) {
+            for (int c = 0; c < 4; ++c)
+                out[c] = m[c * 4 + i];
+        };
+        float r0[4], r1[4], r2[4], r3[4];
+        row(0, r0);
+        row(1, r1);
+        row(2, r2);
+        row(3, r3);
+
+        Frustum f;
+        for (int c = 0; c < 4; ++c) {
+            f.planes[0][c] = r3[c] + r0[c]; // Левая
+            f.planes[1][c] = r3[c] - r0[c]; // Правая
+            f.planes[2][c] = r3[c] + r1[c]; // Нижняя
+            f.planes[3][c] = r3[c] - r1[c]; // Верхняя
+            f.planes[4][c] = r3[c] + r2[c]; // Ближняя
+            f.planes[5][c] = r3[c] - r2[c]; // Дальняя
+        }
+        for (auto& p : f.planes) {
+            float len = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            for (float& c : p)
+                c /= len;
+        }
+        return f;
+    }
+
+    bool intersectsSphere(const float center[3], float radius) const {
+        for (const auto& p : planes)
+            if (p[0] * center[0] + p[1] * center[1] + p[2] * center[2] + p[3] < -radius)
+                return false;
+        return true;
+    }
+
+    // Результат проверки параллелепипеда
+    enum Containment { Outside, Intersects, Inside };
+
+    Containment testBox(const float lo[3], const float hi[3]) const {
+        Containment result = Inside;
+        for (const auto& p : planes) {
+            // Вершина, дальше всех по направлению нормали, и противоположная ей
+            float px = p[0] >= 0 ? hi[0] : lo[0], nx = p[0] >= 0 ? lo[0] : hi[0];
+            float py = p[1] >= 0 ? hi[1] : lo[1], ny = p[1] >= 0 ? lo[1] : hi[1];
+            float pz = p[2] >= 0 ? hi[2] : lo[2], nz = p[2] >= 0 ? lo[2] : hi[2];
+            if (p[0] * px + p[1] * py + p[2] * pz + p[3] < 0)
+                return Outside;
+            if (p[0] * nx + p[1] * ny + p[2] * nz + p[3] < 0)
+                result = Intersects;
+        }
+        return result;
+    }
+
+    // Ограничивающий параллелепипед пирамиды по её восьми вершинам (пересечениям
+    // троек плоскостей); если вершины не найти, границы бесконечны
+    void bounds(float lo[3], float hi[3]) const {
+        for (int i = 0; i < 3; ++i) {
+            lo[i] = INFINITY;
+            hi[i] = -INFINITY;
+        }
+        for (int x = 0; x < 2; ++x)
+            for (int y = 2; y < 4; ++y)
+                for (int z = 4; z < 6; ++z) {
+                    float corner[3];
+                    if (!intersect(planes[x], planes[y], planes[z], corner)) {
+                        for (int i = 0; i < 3; ++i) {
+                            lo[i] = -INFINITY;
+                            hi[i] = INFINITY;
+                        }
+                        return;
+                    }
+                    for (int i = 0; i < 3; ++i) {
+                        lo[i] = std::min(lo[i], corner[i]);
+                        hi[i] = std::max(hi[i], corner[i]);
+                    }
+                }
+    }
+
+private:
+    // Точка пересечения трёх плоскостей: -(d1 (n2 x n3) + d2 (n3 x n1) + d3 (n1 x n2)) / (n1 . (n2 x n3))
+    static bool intersect(const float* p1, const float* p2, const float* p3, float out[3]) {
+        auto cross = [](const float* a, const float* b, float r[3]) {
+            r[0] = a[1] * b[2] - a[2] * b[1];
+            r[1] = a[2] * b[0] - a[0] * b[2];
+            r[2] = a[0] * b[1] - a[1] * b[0];
+        };
+        float c23[3], c31[3], c12[3];
+        cross(p2, p3, c23);
+        cross(p3, p1, c31);
+        cross(p1, p2, c12);
+        float det = p1[0] * c23[0] + p1[1] * c23[1] + p1[2] * c23[2];
+        if (std::abs(det) < 1e-12f)
+            return false;
+        for (int i = 0; i < 3; ++i) {
+            out[i] = -(p1[3] * c23[i] + p2[3] * c31[i] + p3[3] * c12[i]) / det;
+            if (!std::isfinite(out[i]))
+                return false;
+        }
+        return true;
+    }
+};
+
+// Равномерная сетка для отсечения объектов по ограничивающим сферам
+// Объект хранится в ячейке своего центра; границы ячейки при проверке
+// расширяются на наибольший радиус её объектов ("рыхлая" сетка), поэтому
+// объект можно перемещать между ячейками за O(1). Запрос обходит только ячейки,
+// которые могут пересекать параллелепипед пирамиды видимости.
+class UniformGrid {
+public:
+    explicit UniformGrid(float cellSize) : cellSize(cellSize) {}
+
+    // Добавление или обновление объекта id (вызывать при изменении его трансформации)
+    void update(uint32_t id, const float center[3], float radius) {
+        if (id >= entries.size())
+            entries.resize(id + 1);
+        Entry& e = entries[id];
+        int32_t coords[3];
+        for (int i = 0; i < 3; ++i)
+            coords[i] = cellCoord(center[i]);
+        uint64_t key = cellKey(coords);
+        if (e.cell >= 0 && cells[e.cell].key != key)
+            removeFromCell(id);
+
+        // Объект остался в ячейке, но уменьшился: если он был наибольшим, радиус ячейки пересчитывается
+        bool shrunk = e.cell >= 0 && radius < e.radius && e.radius >= cells[e.cell].looseRadius;
+        for (int i = 0; i < 3; ++i)
+            e.center[i] = center[i];
+        e.radius = radius;
+        if (e.cell < 0)
+            addToCell(id, key, coords);
+
+        Cell& cell = cells[e.cell];
+        if (shrunk)
+            recomputeLooseRadius(cell);
+        cell.looseRadius = std::max(cell.looseRadius, radius);
+        maxLooseRadius = std::max(maxLooseRadius, radius);
+    }
+
+    // Вызов visit(id) для каждого объекта, пересекающего пирамиду видимости
+    template <typename Visitor>
+    void query(const Frustum& frustum, Visitor visit) const {
+        // Центры видимых объектов лежат не дальше maxLooseRadius от параллелепипеда пирамиды
+        float lo[3], hi[3];
+        frustum.bounds(lo, hi);
+        int32_t first[3], last[3];
+        uint64_t rangeCells = 1;
+        for (int i = 0; i < 3; ++i) {
+            first[i] = cellCoord(lo[i] - maxLooseRadius);
+            last[i] = cellCoord(hi[i] + maxLooseRadius);
+            rangeCells *= uint64_t(last[i] - first[i] + 1);
+        }
+
+        // Диапазон меньше числа ячеек - поиск каждой ячейки диапазона по ключу,
+        // иначе обход заведённых ячеек с отбрасыванием лежащих вне диапазона
+        if (rangeCells < cells.size()) {
+            int32_t coords[3];
+            for (coords[0] = first[0]; coords[0] <= last[0]; ++coords[0])
+                for (coords[1] = first[1]; coords[1] <= last[1]; ++coords[1])
+                    for (coords[2] = first[2]; coords[2] <= last[2]; ++coords[2]) {
+                        auto it = cellIndex.find(cellKey(coords));
+                        if (it != cellIndex.end())
+                            queryCell(cells[it->second], frustum, visit);
+                    }
+        } else {
+            for (const Cell& cell : cells) {
+                bool inRange = true;
+                for (int i = 0; i < 3; ++i)
+                    inRange = inRange && cell.coords[i] >= first[i] && cell.coords[i] <= last[i];
+                if (inRange)
+                    queryCell(cell, frustum, visit);
+            }
+        }
+    }
+
+    size_t objectCount() const { return entries.size(); }
+
+private:
+    struct Entry {
+        float center[3] = {0, 0, 0};
+        float radius = 0;
+        int32_t cell = -1;  // Индекс ячейки в cells
+        uint32_t slot = 0;  // Позиция в списке объектов ячейки
+    };
+
+    struct Cell {
+        uint64_t key;
+        int32_t coords[3];
+        float looseRadius = 0;
+        std::vector<uint32_t> objects;
+    };
+
+    template <typename Visitor>
+    void queryCell(const Cell& cell, const Frustum& frustum, Visitor& visit) const {
+        if (cell.objects.empty())
+            return;
+        float lo[3], hi[3];
+        for (int i = 0; i < 3; ++i) {
+            lo[i] = cell.coords[i] * cellSize - cell.looseRadius;
+            hi[i] = (cell.coords[i] + 1) * cellSize + cell.looseRadius;
+        }
+        Frustum::Containment c = frustum.testBox(lo, hi);
+        if (c == Frustum::Outside)
+            return;
+        for (uint32_t id : cell.objects) {
+            // Ячейка целиком внутри - проверять объекты по отдельности не нужно
+            if (c == Frustum::Inside || frustum.intersectsSphere(entries[id].center, entries[id].radius))
+                visit(id);
+        }
+    }
+
+    // Номер ячейки по координате; ограничен 21 битом ключа (бесконечность - крайняя ячейка)
+    int32_t cellCoord(float x) const {
+        const float limit = float(1 << 20);
+        return static_cast<int32_t>(std::floor(std::min(std::max(x / cellSize, -limit), limit - 1)));
+    }
+
+    static uint64_t cellKey(const int32_t coords[3]) {
+        uint64_t key = 0;
+        for (int i = 0; i < 3; ++i)
+            key = (key << 21) | (static_cast<uint64_t>(coords[i]) & 0x1fffff); // 21 бит на ось
+        return key;
+    }
+
+    void addToCell(uint32_t id, uint64_t key, const int32_t coords[3]) {
+        auto it = cellIndex.find(key);
+        int32_t index;
+        if (it == cellIndex.end()) {
+            index = static_cast<int32_t>(cells.size());
+            Cell cell;
+            cell.key = key;
+            for (int i = 0; i < 3; ++i)
+                cell.coords[i] = coords[i];
+            cells.push_back(cell);
+            cellIndex[key] = index;
+        } else {
+            index = it->second;
+        }
+
+        Cell& cell = cells[index];
+        entries[id].cell = index;
+        entries[id].slot = static_cast<uint32_t>(cell.objects.size());
+        cell.objects.push_back(id);
+    }
+
+    // Удаление перестановкой последнего элемента на место удаляемого
+    void removeFromCell(uint32_t id) {
+        Entry& e = entries[id];
+        Cell& cell = cells[e.cell];
+        uint32_t last = cell.objects.back();
+        cell.objects[e.slot] = last;
+        entries[last].slot = e.slot;
+        cell.objects.pop_back();
+        e.cell = -1;
+        if (e.radius >= cell.looseRadius)
+            recomputeLooseRadius(cell);
+    }
+
+    // Радиус ячейки заново по её объектам (ушёл или уменьшился наибольший);
+    // если это была наибольшая ячейка, заново считается и общий maxLooseRadius
+    void recomputeLooseRadius(Cell& cell) {
+        float previous = cell.looseRadius;
+        cell.looseRadius = 0;
+        for (uint32_t id : cell.objects)
+            cell.looseRadius = std::max(cell.looseRadius, entries[id].radius);
+        if (cell.looseRadius < previous && previous >= maxLooseRadius) {
+            maxLooseRadius = 0;
+            for (const Cell& other : cells)
+                maxLooseRadius = std::max(maxLooseRadius, other.looseRadius);
+        }
+    }
+
+    float cellSize;
+    float maxLooseRadius = 0; // Наибольший радиус ячейки по всей сетке
+    std::vector<Entry> entries;
+    std::vector<Cell> cells;
+    std::unordered_map<uint64_t, int32_t> cellIndex;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../lab_2/mat4.h"
+
+// Иерархия трансформаций в плоских массивах
+// Узлы хранятся в порядке обхода в глубину: родитель всегда раньше детей,
+// а всё поддерево узла i занимает отрезок [i, i + subtreeSize[i]).
+// Поэтому пересчёт изменённого узла - это один проход по непрерывному
+// отрезку, и его стоимость зависит только от размера поддерева.
+class SceneGraph {
+public:
+    // Добавление узла (parent = -1 для корня)
+    // Узлы добавляются в порядке обхода в глубину: родитель должен быть
+    // последним добавленным узлом или его предком. Возвращает индекс узла или -1.
+    int addNode(int parent, const Mat4& local) {
+        int id = static_cast<int>(parents.size());
+        if (parent >= id || (parent >= 0 && parent + subtreeSizes[parent] != id))
+            return -1;
+
+        parents.push_back(parent);
+        subtreeSizes.push_back(1);
+        locals.push_back(local);
+        worlds.push_back(parent >= 0 ? worlds[parent] * local : local);
+        dirty.push_back(0);
+        for (int p = parent; p >= 0; p = parents[p])
+            ++subtreeSizes[p];
+        return id;
+    }
+
+    // Новая локальная матрица узла; мировые матрицы поддерева пересчитает update()
+    void setLocal(int id, const Mat4& local) {
+        locals[id] = local;
+        if (!dirty[id]) {
+            dirty[id] = 1;
+            dirtyRoots.push_back(id);
+        }
+    }
+
+    // Пересчёт мировых матриц изменённых поддеревьев
+    // Для каждого пересчитанного узла вызывается changed(id); возвращает их число
+    template <typename Callback>
+    size_t update(Callback changed) {
+        if (dirtyRoots.empty())
+            return 0;
+
+        // По возрастанию индексов поддерево, вложенное в уже пересчитанное, пропускается
+        std::sort(dirtyRoots.begin(), dirtyRoots.end());
+        size_t updated = 0;
+        int coveredEnd = 0;
+        for (int root : dirtyRoots) {
+            dirty[root] = 0;
+            if (root < coveredEnd)
+                continue;
+            int end = root + subtreeSizes[root];
+            for (int i = root; i < end; ++i) {
+                int p = parents[i];
+                worlds[i] = p >= 0 ? worlds[p] * locals[i] : locals[i];
+                changed(i);
+            }
+            updated += end - root;
+            coveredEnd = end;
+        }
+        dirtyRoots.clear();
+        return updated;
+    }
+
+    size_t update() {
+        return update([](int) {});
+    }
+
+    size_t size() const { return parents.size(); }
+    int parent(int id) const { return parents[id]; }
+    int subtreeSize(int id) const { return subtreeSizes[id]; }
+    const Mat4& local(int id) const { return locals[id]; }
+    const Mat4& world(int id) const { return worlds[id]; }
+
+private:
+    std::vector<int> parents;
+    std::vector<int> subtreeSizes;
+    std::vector<Mat4> locals;
+    std::vector<Mat4> worlds;
+    std::vector<uint8_t> dirty;
+    std::vector<int> dirtyRoots;
+};
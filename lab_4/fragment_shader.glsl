@@ -8,8 +8,14 @@ in mat3 TBN;
 
 uniform sampler2D diffuseMap;
 uniform sampler2D normalMap;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
+
+// Общие данные кадра (камера и свет), привязка FRAME_DATA_BINDING
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 viewPos;
+};
 
 uniform bool useNormalMap; // Переключатель между стандартным затенением и normal mapping
 
@@ -27,13 +33,13 @@ void main()
 
     // Освещение
     vec3 color = texture(diffuseMap, TexCoords).rgb;
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
     float diff = max(dot(normal, lightDir), 0.0);
 
     vec3 diffuse = diff * color;
 
     // Зеркальное освещение
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
     vec3 reflectDir = reflect(-lightDir, normal);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
     vec3 specular = vec3(0.2) * spec;
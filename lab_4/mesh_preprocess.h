@@ -0,0 +1,154 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// Структура для вершины
+// Тангент хранится вместе со знаком ориентации базиса в w:
+// bitangent = cross(normal, tangent.xyz) * tangent.w
+struct Vertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoords;
+    glm::vec4 tangent;
+};
+
+// Параллельный цикл по диапазону [0, count) на threadCount потоках
+// fn(begin, end) вызывается для непрерывных непересекающихся отрезков
+template <typename Fn>
+void parallelFor(size_t count, unsigned threadCount, Fn fn) {
+    // Мелкие задачи не стоят запуска потоков
+    const size_t minChunk = 16384;
+    size_t chunks = std::min<size_t>(threadCount, (count + minChunk - 1) / minChunk);
+    if (chunks <= 1) {
+        fn(size_t(0), count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t begin = c * chunkSize;
+        size_t end = std::min(count, begin + chunkSize);
+        threads.emplace_back([=]() { fn(begin, end); });
+    }
+    fn(size_t(0), std::min(count, chunkSize));
+    for (auto& thread : threads)
+        thread.join();
+}
+
+// Вектор, перпендикулярный n (для вершин без корректного UV-базиса)
+inline glm::vec3 anyPerpendicular(const glm::vec3& n) {
+    glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    return glm::normalize(glm::cross(n, axis));
+}
+
+// Функция для вычисления тангентов
+// Работает в три прохода без гонок данных:
+//   1) тангент и битангент каждого треугольника считаются параллельно;
+//   2) строится список треугольников каждой вершины (CSR, порядок по индексу треугольника);
+//   3) каждая вершина параллельно суммирует свои треугольники и ортогонализуется.
+// Порядок суммирования фиксирован, поэтому результат не зависит от числа потоков.
+// Треугольники с вырожденными UV (нулевой определитель) не вносят вклада.
+inline void calculateTangents(std::vector<Vertex>& vertices, const std::vector<GLuint>& indices,
+                              unsigned threadCount = std::max(1u, std::thread::hardware_concurrency())) {
+    const size_t triangleCount = indices.size() / 3;
+
+    // Проход 1: базис каждого треугольника (без нормализации - вес по площади)
+    std::vector<glm::vec3> triTangents(triangleCount);
+    std::vector<glm::vec3> triBitangents(triangleCount);
+    parallelFor(triangleCount, threadCount, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const Vertex& v0 = vertices[indices[3 * t]];
+            const Vertex& v1 = vertices[indices[3 * t + 1]];
+            const Vertex& v2 = vertices[indices[3 * t + 2]];
+
+            glm::vec3 edge1 = v1.position - v0.position;
+            glm::vec3 edge2 = v2.position - v0.position;
+
+            glm::vec2 deltaUV1 = v1.texCoords - v0.texCoords;
+            glm::vec2 deltaUV2 = v2.texCoords - v0.texCoords;
+
+            float det = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
+            if (std::abs(det) < 1e-12f) {
+                triTangents[t] = glm::vec3(0.0f);
+                triBitangents[t] = glm::vec3(0.0f);
+                continue;
+            }
+
+            float f = 1.0f / det;
+            triTangents[t] = f * (deltaUV2.y * edge1 - deltaUV1.y * edge2);
+            triBitangents[t] = f * (-deltaUV2.x * edge1 + deltaUV1.x * edge2);
+        }
+    });
+
+    // Проход 2: треугольники, прилегающие к каждой вершине
+    std::vector<GLuint> offsets(vertices.size() + 1, 0);
+    for (GLuint index : indices)
+        ++offsets[index + 1];
+    for (size_t i = 1; i < offsets.size(); ++i)
+        offsets[i] += offsets[i - 1];
+
+    std::vector<GLuint> vertexTriangles(triangleCount * 3);
+    std::vector<GLuint> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+        vertexTriangles[cursor[indices[i]]++] = static_cast<GLuint>(i / 3);
+
+    // Проход 3: сумма по треугольникам, ортогонализация Грама-Шмидта и знак базиса
+    parallelFor(vertices.size(), threadCount, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            glm::vec3 tangent(0.0f), bitangent(0.0f);
+            for (GLuint k = offsets[v]; k < offsets[v + 1]; ++k) {
+                tangent += triTangents[vertexTriangles[k]];
+                bitangent += triBitangents[vertexTriangles[k]];
+            }
+
+            glm::vec3 n = vertices[v].normal;
+            glm::vec3 t = tangent - n * glm::dot(n, tangent);
+            float length = glm::length(t);
+            t = length > 1e-12f ? t / length : anyPerpendicular(n);
+
+            float handedness = glm::dot(glm::cross(n, t), bitangent) < 0.0f ? -1.0f : 1.0f;
+            vertices[v].tangent = glm::vec4(t, handedness);
+        }
+    });
+}
+
+// Генерация UV-сферы: (segments + 1)^2 вершин, 2 * segments^2 треугольников
+inline void generateSphere(int segments, float radius, std::vector<Vertex>& vertices, std::vector<GLuint>& indices) {
+    const float PI = 3.14159265359f;
+    vertices.clear();
+    indices.clear();
+    vertices.reserve(size_t(segments + 1) * (segments + 1));
+    indices.reserve(size_t(segments) * segments * 6);
+
+    for (int i = 0; i <= segments; ++i) {
+        float v = float(i) / segments;
+        float theta = v * PI;
+        for (int j = 0; j <= segments; ++j) {
+            float u = float(j) / segments;
+            float phi = u * 2.0f * PI;
+            glm::vec3 n(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            Vertex vertex;
+            vertex.position = n * radius;
+            vertex.normal = n;
+            vertex.texCoords = glm::vec2(u * 4.0f, v * 2.0f);
+            vertex.tangent = glm::vec4(0.0f);
+            vertices.push_back(vertex);
+        }
+    }
+
+    for (int i = 0; i < segments; ++i) {
+        for (int j = 0; j < segments; ++j) {
+            GLuint a = i * (segments + 1) + j;
+            GLuint b = a + segments + 1;
+            indices.insert(indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Каталог для кэша бинарных шейдерных программ
+const char* const SHADER_CACHE_DIR = "shader_cache";
+
+// Чтение исходного текста шейдера
+inline std::string readShaderFile(const char* path) {
+    std::ifstream file(path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+// Функция для компиляции шейдера (0 при ошибке)
+inline GLuint compileShader(const char* shaderCode, GLenum shaderType) {
+    GLuint shader = glCreateShader(shaderType);
+    glShaderSource(shader, 1, &shaderCode, NULL);
+    glCompileShader(shader);
+
+    // Проверка на ошибки компиляции
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        std::cerr << "Ошибка компиляции шейдера:\n" << infoLog << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Поддерживает ли драйвер получение бинарного кода программы
+inline bool programBinarySupported() {
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+        return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+// Ключ кэша: FNV-1a от исходников и строк драйвера
+// Бинарный код действителен только для того же драйвера и его версии
+inline std::string programCacheKey(const std::string& vertexCode, const std::string& fragmentCode) {
+    uint64_t hash = 14695981039346656037ull;
+    auto feed = [&hash](const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        hash ^= 0xff; // Разделитель между частями ключа
+        hash *= 1099511628211ull;
+    };
+    feed(vertexCode.data(), vertexCode.size());
+    feed(fragmentCode.data(), fragmentCode.size());
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const char* str = reinterpret_cast<const char*>(glGetString(name));
+        if (str)
+            feed(str, std::char_traits<char>::length(str));
+    }
+
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+
+// Загрузка программы из кэша (0, если записи нет или драйвер её отверг)
+inline GLuint loadProgramBinary(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return 0;
+
+    GLenum format = 0;
+    if (!file.read(reinterpret_cast<char*>(&format), sizeof(format)))
+        return 0;
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (binary.empty())
+        return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Сохранение бинарного кода программы в кэш
+inline void saveProgramBinary(GLuint program, const std::string& path) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, NULL, &format, binary.data());
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    // Запись во временный файл и переименование, чтобы не оставить обрезанную запись
+    std::string tmpPath = path + ".tmp";
+    std::ofstream file(tmpPath, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+    file.write(binary.data(), binary.size());
+    file.close();
+    if (file)
+        std::filesystem::rename(tmpPath, path, ec);
+}
+
+// Компиляция и линковка программы из исходников (0 при ошибке)
+inline GLuint linkShaderProgram(const std::string& vertexCode, const std::string& fragmentCode, bool retrievable) {
+    GLuint vertexShader = compileShader(vertexCode.c_str(), GL_VERTEX_SHADER);
+    GLuint fragmentShader = compileShader(fragmentCode.c_str(), GL_FRAGMENT_SHADER);
+    if (!vertexShader || !fragmentShader) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    // Создание шейдерной программы
+    GLuint shaderProgram = glCreateProgram();
+    if (retrievable)
+        glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    glLinkProgram(shaderProgram);
+
+    // Удаление шейдеров после линковки
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    // Проверка на ошибки линковки
+    GLint success;
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+        std::cerr << "Ошибка линковки шейдерной программы:\n" << infoLog << std::endl;
+        glDeleteProgram(shaderProgram);
+        return 0;
+    }
+    return shaderProgram;
+}
+
+// Создание программы с использованием кэша бинарного кода
+// fromCache (если задан) сообщает, была ли программа взята из кэша
+inline GLuint buildShaderProgram(const std::string& vertexCode, const std::string& fragmentCode, bool* fromCache = nullptr) {
+    if (fromCache)
+        *fromCache = false;
+
+    bool useCache = programBinarySupported();
+    std::string cachePath;
+    if (useCache) {
+        cachePath = std::string(SHADER_CACHE_DIR) + "/" + programCacheKey(vertexCode, fragmentCode) + ".bin";
+        if (GLuint program = loadProgramBinary(cachePath)) {
+            if (fromCache)
+                *fromCache = true;
+            return program;
+        }
+    }
+
+    GLuint program = linkShaderProgram(vertexCode, fragmentCode, useCache);
+    if (program && useCache)
+        saveProgramBinary(program, cachePath);
+    return program;
+}
+
+// Функция для создания шейдерной программы из файлов (0 при ошибке)
+inline GLuint createShaderProgram(const char* vertexPath, const char* fragmentPath, bool* fromCache = nullptr) {
+    return buildShaderProgram(readShaderFile(vertexPath), readShaderFile(fragmentPath), fromCache);
+}
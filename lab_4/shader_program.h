@@ -0,0 +1,136 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "../common/gl_profiler.h" // Счётчики GL_COUNTED / GL_STATE / GL_DRAW
+
+// Точка привязки общего UBO с данными камеры и света
+const GLuint FRAME_DATA_BINDING = 0;
+
+// Данные кадра, общие для всех шейдерных программ (layout std140)
+// Должна совпадать с блоком FrameData в шейдерах
+struct FrameData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 lightPos; // w не используется
+    glm::vec4 viewPos;  // w не используется
+};
+
+// Uniform-буфер с данными кадра
+class FrameUniformBuffer {
+public:
+    FrameUniformBuffer() {
+        glGenBuffers(1, &ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    ~FrameUniformBuffer() {
+        glDeleteBuffers(1, &ubo);
+    }
+
+    FrameUniformBuffer(const FrameUniformBuffer&) = delete;
+    FrameUniformBuffer& operator=(const FrameUniformBuffer&) = delete;
+
+    // Загрузка данных (вызывать только при изменении камеры или света)
+    void update(const FrameData& data) {
+        GL_STATE(glBindBuffer(GL_UNIFORM_BUFFER, ubo));
+        GL_COUNTED(glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data));
+        GL_STATE(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+    }
+
+private:
+    GLuint ubo = 0;
+};
+
+// Обёртка над шейдерной программой
+// Расположения uniform-переменных запрашиваются один раз после линковки
+class ShaderProgram {
+public:
+    explicit ShaderProgram(GLuint program) {
+        reset(program);
+    }
+
+    ~ShaderProgram() {
+        if (id)
+            glDeleteProgram(id);
+    }
+
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+    // Замена программы (старая удаляется) и повторное чтение uniform-переменных
+    void reset(GLuint program) {
+        if (id && id != program)
+            glDeleteProgram(id);
+        id = program;
+        reflect();
+    }
+
+    GLuint handle() const { return id; }
+
+    void use() const {
+        GL_STATE(glUseProgram(id));
+    }
+
+    // Расположение uniform-переменной из кэша (-1, если переменной нет)
+    GLint location(const std::string& name) const {
+        auto it = locations.find(name);
+        return it != locations.end() ? it->second : -1;
+    }
+
+    // Установка значений (программа должна быть активна)
+    void set(const std::string& name, int value) const {
+        GL_STATE(glUniform1i(location(name), value));
+    }
+
+    void set(const std::string& name, const glm::vec3& value) const {
+        GL_STATE(glUniform3fv(location(name), 1, glm::value_ptr(value)));
+    }
+
+    void set(const std::string& name, const glm::mat4& value) const {
+        GL_STATE(glUniformMatrix4fv(location(name), 1, GL_FALSE, glm::value_ptr(value)));
+    }
+
+private:
+    // Чтение активных uniform-переменных и привязка блока FrameData
+    void reflect() {
+        locations.clear();
+
+        GLint count = 0;
+        glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+        for (GLint i = 0; i < count; ++i) {
+            GLchar name[256];
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(id, i, sizeof(name), &length, &size, &type, name);
+
+            // Члены uniform-блоков не имеют собственного расположения
+            GLint loc = glGetUniformLocation(id, name);
+            if (loc < 0)
+                continue;
+
+            // Для массивов драйвер возвращает имя с суффиксом "[0]"
+            std::string key(name, length);
+            if (key.size() > 3 && key.compare(key.size() - 3, 3, "[0]") == 0)
+                key.resize(key.size() - 3);
+            locations[key] = loc;
+        }
+
+        GLuint blockIndex = glGetUniformBlockIndex(id, "FrameData");
+        if (blockIndex != GL_INVALID_INDEX)
+            glUniformBlockBinding(id, blockIndex, FRAME_DATA_BINDING);
+    }
+
+    GLuint id = 0;
+    std::unordered_map<std::string, GLint> locations;
+};
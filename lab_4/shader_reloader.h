@@ -0,0 +1,98 @@
+#pragma once
+
+#include <SFML/Window.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "shader_cache.h"
+
+// Отслеживание изменений файлов шейдеров и перекомпиляция в фоновом потоке
+// Поток использует собственный контекст OpenGL, разделяющий объекты с окном.
+// Готовая программа забирается основным потоком через takeProgram();
+// при ошибке компиляции продолжает работать прежняя программа.
+class ShaderReloader {
+public:
+    ShaderReloader(const std::string& vertexPath, const std::string& fragmentPath)
+        : vertexPath(vertexPath), fragmentPath(fragmentPath) {
+        vertexTime = modificationTime(vertexPath);
+        fragmentTime = modificationTime(fragmentPath);
+        worker = std::thread(&ShaderReloader::run, this);
+    }
+
+    ~ShaderReloader() {
+        running = false;
+        worker.join();
+        // Программа, которую основной поток так и не забрал, остаётся
+        // в разделяемом пространстве объектов и удаляется вместе с контекстом
+    }
+
+    ShaderReloader(const ShaderReloader&) = delete;
+    ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+    // Новая программа, если она была собрана после предыдущего вызова (иначе 0)
+    GLuint takeProgram() {
+        std::lock_guard<std::mutex> lock(mutex);
+        GLuint program = pending;
+        pending = 0;
+        return program;
+    }
+
+private:
+    static std::filesystem::file_time_type modificationTime(const std::string& path) {
+        std::error_code ec;
+        return std::filesystem::last_write_time(path, ec);
+    }
+
+    void run() {
+        // Контекст потока разделяет объекты с контекстом окна
+        sf::Context context;
+
+        while (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+            auto newVertexTime = modificationTime(vertexPath);
+            auto newFragmentTime = modificationTime(fragmentPath);
+            if (newVertexTime == vertexTime && newFragmentTime == fragmentTime)
+                continue;
+            vertexTime = newVertexTime;
+            fragmentTime = newFragmentTime;
+
+            std::string vertexCode = readShaderFile(vertexPath.c_str());
+            std::string fragmentCode = readShaderFile(fragmentPath.c_str());
+            if (vertexCode.empty() || fragmentCode.empty())
+                continue; // Файл ещё записывается редактором
+
+            auto start = std::chrono::steady_clock::now();
+            GLuint program = buildShaderProgram(vertexCode, fragmentCode);
+            if (!program) {
+                std::cerr << "Шейдеры не перезагружены, используется прежняя программа" << std::endl;
+                continue;
+            }
+            // Программа должна быть полностью готова до использования в другом контексте
+            glFinish();
+            auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "Шейдеры перезагружены за " << ms << " мс" << std::endl;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (pending)
+                glDeleteProgram(pending); // Предыдущая версия так и не была использована
+            pending = program;
+        }
+    }
+
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::filesystem::file_time_type vertexTime;
+    std::filesystem::file_time_type fragmentTime;
+
+    std::atomic<bool> running{true};
+    std::thread worker;
+    std::mutex mutex;
+    GLuint pending = 0;
+};
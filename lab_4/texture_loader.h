@@ -0,0 +1,226 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <SFML/Graphics/Image.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Цепочка мип-уровней в формате RGBA8, уровни лежат в памяти подряд
+struct MipChain {
+    struct Level {
+        unsigned width, height;
+        size_t offset; // Смещение в data
+    };
+    std::vector<Level> levels;
+    std::vector<uint8_t> data;
+    bool hasAlpha = false;
+};
+
+// Построение мип-уровней усреднением блоков 2x2 (для нечётных размеров край повторяется)
+inline MipChain buildMipChain(const uint8_t* pixels, unsigned width, unsigned height) {
+    MipChain chain;
+
+    size_t total = 0;
+    for (unsigned w = width, h = height;; w = std::max(1u, w / 2), h = std::max(1u, h / 2)) {
+        chain.levels.push_back({w, h, total});
+        total += size_t(w) * h * 4;
+        if (w == 1 && h == 1)
+            break;
+    }
+    chain.data.resize(total);
+    std::memcpy(chain.data.data(), pixels, size_t(width) * height * 4);
+
+    // Прозрачность определяется по всем пикселям, а не по первому
+    for (size_t i = 3; i < size_t(width) * height * 4; i += 4) {
+        if (pixels[i] != 255) {
+            chain.hasAlpha = true;
+            break;
+        }
+    }
+
+    for (size_t l = 1; l < chain.levels.size(); ++l) {
+        const MipChain::Level& src = chain.levels[l - 1];
+        const MipChain::Level& dst = chain.levels[l];
+        const uint8_t* in = chain.data.data() + src.offset;
+        uint8_t* out = chain.data.data() + dst.offset;
+
+        for (unsigned y = 0; y < dst.height; ++y) {
+            unsigned y0 = std::min(2 * y, src.height - 1);
+            unsigned y1 = std::min(2 * y + 1, src.height - 1);
+            for (unsigned x = 0; x < dst.width; ++x) {
+                unsigned x0 = std::min(2 * x, src.width - 1);
+                unsigned x1 = std::min(2 * x + 1, src.width - 1);
+                for (int c = 0; c < 4; ++c) {
+                    unsigned sum = in[(size_t(y0) * src.width + x0) * 4 + c] + in[(size_t(y0) * src.width + x1) * 4 + c]
+                                 + in[(size_t(y1) * src.width + x0) * 4 + c] + in[(size_t(y1) * src.width + x1) * 4 + c];
+                    out[(size_t(y) * dst.width + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+    return chain;
+}
+
+// Асинхронная загрузка текстур
+// load() сразу возвращает текстуру с однопиксельной заглушкой; декодирование
+// и построение мип-уровней выполняет пул потоков, а update() в основном потоке
+// загружает готовые изображения в те же текстуры через pixel buffer object.
+class TextureLoader {
+public:
+    explicit TextureLoader(unsigned workerCount = std::max(1u, std::thread::hardware_concurrency())) {
+        glGenBuffers(1, &pbo);
+        for (unsigned i = 0; i < workerCount; ++i)
+            workers.emplace_back(&TextureLoader::workerLoop, this);
+    }
+
+    ~TextureLoader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobsChanged.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+        glDeleteBuffers(1, &pbo);
+    }
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    // Создание текстуры с заглушкой заданного цвета и постановка файла в очередь
+    GLuint load(const std::string& path, const uint8_t placeholder[4]) {
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+
+        // Параметры текстуры (у заглушки нет мип-уровней)
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back({textureID, path});
+            ++inFlight;
+        }
+        jobsChanged.notify_one();
+        return textureID;
+    }
+
+    // Загрузка готовых текстур на GPU (не больше maxUploads за вызов, чтобы не было рывков)
+    void update(unsigned maxUploads = 4) {
+        for (unsigned n = 0; n < maxUploads; ++n) {
+            Result result;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (results.empty())
+                    return;
+                result = std::move(results.front());
+                results.pop_front();
+                --inFlight;
+            }
+            if (!result.chain.levels.empty())
+                upload(result);
+        }
+    }
+
+    // Число текстур, ещё не загруженных на GPU
+    unsigned pending() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return inFlight;
+    }
+
+private:
+    struct Job {
+        GLuint texture;
+        std::string path;
+    };
+
+    struct Result {
+        GLuint texture = 0;
+        MipChain chain; // Пустая при ошибке загрузки
+    };
+
+    void workerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobsChanged.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (stopping)
+                    return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            // sf::Image всегда хранит пиксели в RGBA8
+            Result result;
+            result.texture = job.texture;
+            sf::Image image;
+            if (image.loadFromFile(job.path))
+                result.chain = buildMipChain(image.getPixelsPtr(), image.getSize().x, image.getSize().y);
+            else
+                std::cerr << "Не удалось загрузить текстуру: " << job.path << ", остаётся заглушка" << std::endl;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(std::move(result));
+        }
+    }
+
+    void upload(const Result& result) {
+        const MipChain& chain = result.chain;
+
+        // Копирование в PBO; старое содержимое буфера отбрасывается (orphaning),
+        // чтобы не ждать завершения предыдущей передачи
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, chain.data.size(), NULL, GL_STREAM_DRAW);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, chain.data.size(),
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (!mapped) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return;
+        }
+        std::memcpy(mapped, chain.data.data(), chain.data.size());
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        // Внутренний формат без альфа-канала, если изображение непрозрачное
+        GLint internalFormat = chain.hasAlpha ? GL_RGBA8 : GL_RGB8;
+
+        // Привязка текстуры в активном блоке восстанавливается после загрузки
+        GLint previousTexture = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+        glBindTexture(GL_TEXTURE_2D, result.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        for (size_t l = 0; l < chain.levels.size(); ++l) {
+            const MipChain::Level& level = chain.levels[l];
+            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(l), internalFormat, level.width, level.height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, (void*)level.offset);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(chain.levels.size() - 1));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+        glBindTexture(GL_TEXTURE_2D, previousTexture);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    GLuint pbo = 0;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable jobsChanged;
+    std::deque<Job> jobs;
+    std::deque<Result> results;
+    unsigned inFlight = 0;
+    bool stopping = false;
+};
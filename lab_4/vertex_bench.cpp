@@ -0,0 +1,96 @@
+// Замер кодирования/декодирования компактного формата вершин на большом меше
+// Не требует OpenGL-контекста: всё считается на CPU
+// Каждый этап повторяется (лучшее из нескольких запусков, см. bench/bench_timer.h)
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "../bench/bench_timer.h"
+#include "mesh_preprocess.h"
+#include "vertex_compression.h"
+
+int main(int argc, char** argv) {
+    int segments = argc > 1 ? std::atoi(argv[1]) : 2048;
+
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    generateSphere(segments, 10.0f, vertices, indices);
+    const double count = double(vertices.size());
+    std::cout << "Вершин: " << vertices.size() << ", треугольников: " << indices.size() / 3 << std::endl;
+
+    printResult("Тангенты", measureMs([&] {
+        calculateTangents(vertices, indices);
+        keepResult(vertices);
+    }), count, "вершин");
+
+    // Кодирование
+    CompactMesh mesh;
+    printResult("Кодирование", measureMs([&] {
+        mesh = compressVertices(vertices);
+        keepResult(mesh);
+    }), count, "вершин");
+
+    // Декодирование
+    std::vector<Vertex> decoded(vertices.size());
+    printResult("Декодирование", measureMs([&] {
+        for (size_t i = 0; i < mesh.vertices.size(); ++i)
+            decoded[i] = decompressVertex(mesh.vertices[i], mesh.positionOffset, mesh.positionScale);
+        keepResult(decoded);
+    }), count, "вершин");
+
+    float maxPositionError = 0.0f, maxNormalAngle = 0.0f, maxTangentAngle = 0.0f, maxUVError = 0.0f;
+    size_t signMismatches = 0;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex& a = vertices[i];
+        const Vertex& b = decoded[i];
+        maxPositionError = std::max(maxPositionError, glm::length(a.position - b.position));
+        maxNormalAngle = std::max(maxNormalAngle, std::acos(std::min(1.0f, glm::dot(a.normal, b.normal))));
+        glm::vec3 ta(a.tangent.x, a.tangent.y, a.tangent.z), tb(b.tangent.x, b.tangent.y, b.tangent.z);
+        maxTangentAngle = std::max(maxTangentAngle, std::acos(std::min(1.0f, glm::dot(ta, tb))));
+        maxUVError = std::max({maxUVError, std::abs(a.texCoords.x - b.texCoords.x), std::abs(a.texCoords.y - b.texCoords.y)});
+        if (a.tangent.w != b.tangent.w)
+            ++signMismatches;
+    }
+
+    // Потоковое чтение обоих буферов (оценка нагрузки на память при выборке вершин):
+    // позиция и нормаль каждой вершины; ГБ/с считаются по размеру всего буфера
+    const double fullBytes = count * sizeof(Vertex);
+    const double compactBytes = double(mesh.vertices.size()) * sizeof(CompactVertex);
+    glm::vec3 fullSum(0.0f), compactSum(0.0f);
+    double fullReadMs = measureMs([&] {
+        glm::vec3 sum(0.0f);
+        for (const Vertex& v : vertices)
+            sum += v.position + v.normal;
+        fullSum = sum;
+        keepResult(fullSum);
+    });
+    double compactReadMs = measureMs([&] {
+        glm::vec3 sum(0.0f);
+        for (const CompactVertex& c : mesh.vertices) {
+            Vertex v = decompressVertex(c, mesh.positionOffset, mesh.positionScale);
+            sum += v.position + v.normal;
+        }
+        compactSum = sum;
+        keepResult(compactSum);
+    });
+
+    const float toDegrees = 180.0f / 3.14159265359f;
+    std::cout << "Размер буфера: " << sizeof(Vertex) << " -> " << sizeof(CompactVertex) << " байт на вершину, "
+              << fullBytes / (1024.0 * 1024.0) << " -> " << compactBytes / (1024.0 * 1024.0) << " МБ ("
+              << fullBytes / compactBytes << "x)" << std::endl;
+    printBandwidth("Чтение полного буфера", fullReadMs, fullBytes);
+    printBandwidth("Чтение и декодирование компактного", compactReadMs, compactBytes);
+    std::cout << "Компактный / полный: " << (compactBytes / compactReadMs) / (fullBytes / fullReadMs)
+              << "x по ГБ/с, " << fullReadMs / compactReadMs << "x по вершинам в секунду\n"
+              << "Макс. ошибка позиции: " << maxPositionError << "\n"
+              << "Макс. ошибка нормали: " << maxNormalAngle * toDegrees << " град.\n"
+              << "Макс. ошибка тангента: " << maxTangentAngle * toDegrees << " град.\n"
+              << "Макс. ошибка UV: " << maxUVError << "\n"
+              << "Несовпадений знака битангента: " << signMismatches << "\n"
+              // Суммы выводятся, чтобы компилятор не выбросил циклы чтения
+              << "(" << fullSum.x + compactSum.x << ")" << std::endl;
+    return 0;
+}
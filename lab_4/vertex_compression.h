@@ -0,0 +1,203 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "mesh_preprocess.h"
+
+// Компактная вершина: 20 байт вместо 48 у Vertex
+//   position  - координаты, квантованные в ограничивающий параллелепипед меша (unorm16),
+//               в position[3] - знак битангента (0 -> -1, 65535 -> +1)
+//   normal    - октаэдрически закодированная нормаль (snorm16 x 2)
+//   tangent   - октаэдрически закодированный тангент (snorm16 x 2)
+//   texCoords - текстурные координаты в half float
+struct CompactVertex {
+    uint16_t position[4];
+    int16_t normal[2];
+    int16_t tangent[2];
+    uint16_t texCoords[2];
+};
+
+// Меш в компактном формате и параметры восстановления позиций:
+// position = positionOffset + unorm * positionScale
+struct CompactMesh {
+    std::vector<CompactVertex> vertices;
+    glm::vec3 positionOffset;
+    glm::vec3 positionScale;
+};
+
+// Преобразование float -> half (IEEE 754 binary16, округление к ближайшему)
+inline uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff) // Inf и NaN
+        return static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    if (exponent >= 31) // Переполнение
+        return static_cast<uint16_t>(sign | 0x7c00);
+    if (exponent <= 0) { // Денормализованные числа и ноль
+        if (exponent < -10)
+            return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        ++half; // Перенос в экспоненту обрабатывается сам собой
+    return static_cast<uint16_t>(half);
+}
+
+// Преобразование half -> float
+inline float halfToFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else { // Денормализованное число
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline int16_t floatToSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+inline float snorm16ToFloat(int16_t value) {
+    return std::max(value / 32767.0f, -1.0f);
+}
+
+inline float signNotZero(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+// Октаэдрическое кодирование единичного вектора в два snorm16
+inline void octEncode(const glm::vec3& n, int16_t out[2]) {
+    float invL1 = 1.0f / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+    float x = n.x * invL1;
+    float y = n.y * invL1;
+    if (n.z < 0.0f) { // Нижняя полусфера отражается на углы квадрата
+        float ox = (1.0f - std::abs(y)) * signNotZero(x);
+        float oy = (1.0f - std::abs(x)) * signNotZero(y);
+        x = ox;
+        y = oy;
+    }
+    out[0] = floatToSnorm16(x);
+    out[1] = floatToSnorm16(y);
+}
+
+// Декодирование (то же самое делает вершинный шейдер)
+inline glm::vec3 octDecode(const int16_t in[2]) {
+    float x = snorm16ToFloat(in[0]);
+    float y = snorm16ToFloat(in[1]);
+    glm::vec3 n(x, y, 1.0f - std::abs(x) - std::abs(y));
+    if (n.z < 0.0f) {
+        n.x = (1.0f - std::abs(y)) * signNotZero(x);
+        n.y = (1.0f - std::abs(x)) * signNotZero(y);
+    }
+    return glm::normalize(n);
+}
+
+// Перевод меша в компактный формат
+inline CompactMesh compressVertices(const std::vector<Vertex>& vertices) {
+    CompactMesh mesh;
+    glm::vec3 lo(0.0f), hi(0.0f);
+    if (!vertices.empty()) {
+        lo = hi = vertices[0].position;
+        for (const Vertex& v : vertices) {
+            lo = glm::min(lo, v.position);
+            hi = glm::max(hi, v.position);
+        }
+    }
+    mesh.positionOffset = lo;
+    mesh.positionScale = (hi - lo) / 65535.0f;
+
+    // Нулевой размер по оси не должен приводить к делению на ноль
+    glm::vec3 invScale;
+    for (int axis = 0; axis < 3; ++axis)
+        invScale[axis] = mesh.positionScale[axis] > 0.0f ? 1.0f / mesh.positionScale[axis] : 0.0f;
+
+    mesh.vertices.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex& v = vertices[i];
+        CompactVertex& c = mesh.vertices[i];
+
+        glm::vec3 q = (v.position - lo) * invScale;
+        for (int axis = 0; axis < 3; ++axis)
+            c.position[axis] = static_cast<uint16_t>(std::lround(std::clamp(q[axis], 0.0f, 65535.0f)));
+        c.position[3] = v.tangent.w < 0.0f ? 0 : 65535;
+
+        octEncode(v.normal, c.normal);
+        octEncode(glm::vec3(v.tangent.x, v.tangent.y, v.tangent.z), c.tangent);
+
+        c.texCoords[0] = floatToHalf(v.texCoords.x);
+        c.texCoords[1] = floatToHalf(v.texCoords.y);
+    }
+    return mesh;
+}
+
+// Восстановление вершины (для проверки точности и замеров на CPU)
+inline Vertex decompressVertex(const CompactVertex& c, const glm::vec3& positionOffset, const glm::vec3& positionScale) {
+    Vertex v;
+    v.position = positionOffset + glm::vec3(c.position[0], c.position[1], c.position[2]) * positionScale;
+    v.normal = octDecode(c.normal);
+    v.texCoords = glm::vec2(halfToFloat(c.texCoords[0]), halfToFloat(c.texCoords[1]));
+    v.tangent = glm::vec4(octDecode(c.tangent), c.position[3] ? 1.0f : -1.0f);
+    return v;
+}
+
+// Настройка атрибутов компактного формата для текущего VAO
+// Расположения совпадают с полным форматом; декодирование - в вершинном шейдере
+inline void setupCompactVertexAttributes() {
+    // Позиция (unorm16 x 4, w - знак битангента)
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, position));
+
+    // Нормаль (октаэдрическая, snorm16 x 2)
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, normal));
+
+    // Текстурные координаты (half float x 2)
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, texCoords));
+
+    // Тангент (октаэдрический, snorm16 x 2)
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, tangent));
+}
@@ -1,28 +1,64 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;      // Позиция
+// В компактном формате (CompactVertex) атрибуты нормализованы драйвером:
+// aPos.xyz - позиция в долях ограничивающего параллелепипеда, aPos.w - знак битангента,
+// aNormal.xy и aTangent.xy - октаэдрические координаты
+layout (location = 0) in vec4 aPos;      // Позиция
 layout (location = 1) in vec3 aNormal;   // Нормаль
 layout (location = 2) in vec2 aTexCoords;// Текстурные координаты
-layout (location = 3) in vec3 aTangent;  // Тангенты
-layout (location = 4) in vec3 aBitangent;// Битангенты
+layout (location = 3) in vec4 aTangent;  // Тангенты, w - знак битангента
 
 out vec2 TexCoords;
 out vec3 FragPos;
 out mat3 TBN;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Параметры компактного формата вершин
+uniform bool compactVertices;
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+
+// Общие данные кадра (камера и свет), привязка FRAME_DATA_BINDING
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 viewPos;
+};
+
+// Декодирование октаэдрически закодированного единичного вектора
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(e.yx)) * vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    vec3 position, normal, tangent;
+    float handedness;
+    if (compactVertices) {
+        position = positionOffset + aPos.xyz * 65535.0 * positionScale;
+        normal = octDecode(aNormal.xy);
+        tangent = octDecode(aTangent.xy);
+        handedness = aPos.w * 2.0 - 1.0;
+    } else {
+        position = aPos.xyz;
+        normal = aNormal;
+        tangent = aTangent.xyz;
+        handedness = aTangent.w;
+    }
+
+    FragPos = vec3(model * vec4(position, 1.0));
     TexCoords = aTexCoords;
 
     // Вычисление TBN матрицы
-    vec3 T = normalize(vec3(model * vec4(aTangent, 0.0)));
-    vec3 B = normalize(vec3(model * vec4(aBitangent, 0.0)));
-    vec3 N = normalize(vec3(model * vec4(aNormal, 0.0)));
+    vec3 T = normalize(vec3(model * vec4(tangent, 0.0)));
+    vec3 N = normalize(vec3(model * vec4(normal, 0.0)));
+    vec3 B = cross(N, T) * handedness; // Битангент восстанавливается из нормали и тангента
     TBN = mat3(T, B, N);
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
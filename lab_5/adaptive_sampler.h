@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "raytracer.h"
+
+// Адаптивная выборка лучей для сглаживания
+//
+// Первый проход даёт каждому пикселю initialSamples лучей. Для каждого пикселя по
+// алгоритму Уэлфорда накапливаются среднее и дисперсия цвета, и по ним оценивается
+// стандартная ошибка среднего (с учётом соседних пикселей). Дальше идут проходы по
+// тайлам: тайлы, в которых ошибка хотя бы одного пикселя выше порога, сортируются по
+// убыванию ошибки и обрабатываются в этом порядке. Пикселю с ошибкой выше порога
+// добавляется batchSamples лучей, пока их не станет maxSamples. Однотонные
+// области (фон, середина сферы) остаются с начальным числом лучей, а дополнительные
+// лучи уходят на края сферы, отражения и мелкий рисунок текстур.
+
+struct AdaptiveSettings {
+    int initialSamples = 4; // Лучей на пиксель в первом проходе (не меньше 2 для оценки дисперсии)
+    int batchSamples = 4;   // Лучей, добавляемых пикселю за проход
+    int maxSamples = 64;    // Наибольшее число лучей на пиксель
+    double threshold = 0.01; // Допустимая стандартная ошибка среднего (цвет в [0, 1])
+    int tileSize = 16;
+};
+
+// Оценка цвета пикселя: среднее и сумма квадратов отклонений по каналам
+struct PixelEstimate {
+    int count = 0;
+    Vec3 mean;
+    Vec3 m2;
+
+    void add(const Vec3& color) {
+        ++count;
+        Vec3 delta = color - mean;
+        mean = mean + delta / count;
+        Vec3 delta2 = color - mean;
+        m2 = m2 + Vec3(delta.x * delta2.x, delta.y * delta2.y, delta.z * delta2.z);
+    }
+
+    // Стандартная ошибка среднего по худшему каналу
+    double error() const {
+        if (count < 2)
+            return std::numeric_limits<double>::infinity();
+        double variance = std::max({m2.x, m2.y, m2.z}) / (count - 1);
+        return std::sqrt(variance / count);
+    }
+};
+
+struct AdaptiveStats {
+    long long samples = 0; // Первичных лучей всего
+    int passes = 0;        // Проходов, включая первый
+    double seconds = 0;
+};
+
+class AdaptiveSampler {
+public:
+    AdaptiveSampler(int width, int height, const AdaptiveSettings& settings = AdaptiveSettings())
+        : width(width), height(height), settings(settings), estimates(size_t(width) * height),
+          ownErrors(size_t(width) * height), errors(size_t(width) * height) {
+        this->settings.initialSamples = std::max(2, settings.initialSamples);
+        this->settings.batchSamples = std::max(1, settings.batchSamples);
+        this->settings.maxSamples = std::max(this->settings.initialSamples, settings.maxSamples);
+        this->settings.tileSize = std::max(1, settings.tileSize);
+        while (latticeAxis * latticeAxis < this->settings.maxSamples && latticeShift > 16) {
+            latticeAxis *= 2;
+            --latticeShift;
+        }
+        tilesX = (width + this->settings.tileSize - 1) / this->settings.tileSize;
+        tilesY = (height + this->settings.tileSize - 1) / this->settings.tileSize;
+    }
+
+    // Отрисовка кадра; tracer(ray) возвращает цвет луча (например, CompiledScene)
+    template <typename Tracer>
+    AdaptiveStats render(const Camera& camera, const Tracer& tracer) {
+        auto start = std::chrono::steady_clock::now();
+        std::fill(estimates.begin(), estimates.end(), PixelEstimate());
+        AdaptiveStats stats;
+
+        // Первый проход: все тайлы
+        std::vector<int> order(tilesX * tilesY);
+        for (int i = 0; i < static_cast<int>(order.size()); ++i)
+            order[i] = i;
+        std::vector<double> tileErrors(order.size(), 0.0);
+        bool firstPass = true;
+
+        while (!order.empty()) {
+            #pragma omp parallel for schedule(dynamic, 1)
+            for (int i = 0; i < static_cast<int>(order.size()); ++i)
+                refineTile(camera, tracer, order[i], firstPass);
+            firstPass = false;
+            ++stats.passes;
+
+            // Ошибки пикселей, ошибки тайлов и порядок следующего прохода:
+            // сначала тайлы с наибольшей ошибкой
+            updateErrors();
+            #pragma omp parallel for schedule(dynamic, 4)
+            for (int tile = 0; tile < tilesX * tilesY; ++tile)
+                tileErrors[tile] = tileError(tile);
+            order.clear();
+            for (int tile = 0; tile < tilesX * tilesY; ++tile)
+                if (tileErrors[tile] > settings.threshold)
+                    order.push_back(tile);
+            std::sort(order.begin(), order.end(), [&tileErrors](int a, int b) { return tileErrors[a] > tileErrors[b]; });
+        }
+
+        for (const PixelEstimate& estimate : estimates)
+            stats.samples += estimate.count;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    const PixelEstimate& pixel(int x, int y) const { return estimates[size_t(y) * width + x]; }
+
+private:
+    // Подпиксельные точки - центры ячеек сетки latticeAxis x latticeAxis (latticeAxis^2 >= maxSamples),
+    // ячейки выбираются по последовательности Соболя (0,2) с XOR-перемешиванием разрядов,
+    // своим у каждого пикселя. Первые 4, 16, 64 точки стратифицированы как сетки 2x2, 4x4,
+    // 8x8, а при maxSamples = 64 все лучи пикселя - это равномерная сетка 8x8. Центры ячеек
+    // здесь важны: на текстурах равномерная сетка заметно точнее случайных точек.
+    template <typename Tracer>
+    void addSamples(const Camera& camera, const Tracer& tracer, int x, int y, PixelEstimate& estimate, int count) const {
+        uint32_t scrambleX = mixBits(static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u);
+        uint32_t scrambleY = mixBits(scrambleX ^ 0x9e3779b9u);
+        for (int i = 0; i < count; ++i) {
+            uint32_t index = static_cast<uint32_t>(estimate.count);
+            double sx = (((reverseBits(index) ^ scrambleX) >> latticeShift) + 0.5) / latticeAxis;
+            double sy = (((sobolSecond(index) ^ scrambleY) >> latticeShift) + 0.5) / latticeAxis;
+            estimate.add(tracer(camera.primaryRay(x + sx, y + sy)));
+        }
+    }
+
+    static uint32_t mixBits(uint32_t value) {
+        value = (value ^ (value >> 16)) * 0x45d9f3bu;
+        value = (value ^ (value >> 16)) * 0x45d9f3bu;
+        return value ^ (value >> 16);
+    }
+
+    // Первое измерение Соболя - обращение порядка бит (ван дер Корпут)
+    static uint32_t reverseBits(uint32_t value) {
+        value = (value << 16) | (value >> 16);
+        value = ((value & 0x00ff00ffu) << 8) | ((value & 0xff00ff00u) >> 8);
+        value = ((value & 0x0f0f0f0fu) << 4) | ((value & 0xf0f0f0f0u) >> 4);
+        value = ((value & 0x33333333u) << 2) | ((value & 0xccccccccu) >> 2);
+        value = ((value & 0x55555555u) << 1) | ((value & 0xaaaaaaaau) >> 1);
+        return value;
+    }
+
+    // Второе измерение Соболя
+    static uint32_t sobolSecond(uint32_t index) {
+        uint32_t result = 0;
+        for (uint32_t v = 1u << 31; index; index >>= 1, v ^= v >> 1)
+            if (index & 1)
+                result ^= v;
+        return result;
+    }
+
+    template <typename Tracer>
+    void refineTile(const Camera& camera, const Tracer& tracer, int tile, bool firstPass) {
+        int x0 = (tile % tilesX) * settings.tileSize, y0 = (tile / tilesX) * settings.tileSize;
+        int x1 = std::min(x0 + settings.tileSize, width), y1 = std::min(y0 + settings.tileSize, height);
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                PixelEstimate& estimate = estimates[size_t(y) * width + x];
+                if (firstPass) {
+                    addSamples(camera, tracer, x, y, estimate, settings.initialSamples);
+                } else if (estimate.count < settings.maxSamples && errors[size_t(y) * width + x] > settings.threshold) {
+                    addSamples(camera, tracer, x, y, estimate,
+                               std::min(settings.batchSamples, settings.maxSamples - estimate.count));
+                }
+            }
+        }
+    }
+
+    // Оценка ошибки пикселя - наибольшая из его собственной и средней по окрестности 3x3.
+    // По нескольким лучам дисперсия оценивается грубо: если все лучи пикселя случайно
+    // попали в похожие точки текстуры, его ошибка занижена, и без учёта соседей такие
+    // пиксели останавливаются раньше времени
+    void updateErrors() {
+        #pragma omp parallel for
+        for (int i = 0; i < width * height; ++i)
+            ownErrors[i] = estimates[i].error();
+        #pragma omp parallel for
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                double sum = 0;
+                int count = 0;
+                for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height - 1); ++ny) {
+                    for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width - 1); ++nx) {
+                        sum += ownErrors[size_t(ny) * width + nx];
+                        ++count;
+                    }
+                }
+                size_t index = size_t(y) * width + x;
+                errors[index] = std::max(ownErrors[index], sum / count);
+            }
+        }
+    }
+
+    // Наибольшая ошибка среди пикселей тайла, которым ещё можно добавить лучи
+    double tileError(int tile) const {
+        int x0 = (tile % tilesX) * settings.tileSize, y0 = (tile / tilesX) * settings.tileSize;
+        int x1 = std::min(x0 + settings.tileSize, width), y1 = std::min(y0 + settings.tileSize, height);
+        double error = 0;
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                size_t index = size_t(y) * width + x;
+                if (estimates[index].count < settings.maxSamples)
+                    error = std::max(error, errors[index]);
+            }
+        }
+        return error;
+    }
+
+    int width, height;
+    AdaptiveSettings settings;
+    int tilesX, tilesY;
+    int latticeAxis = 1, latticeShift = 32;
+    std::vector<PixelEstimate> estimates;
+    std::vector<double> ownErrors; // Стандартная ошибка среднего каждого пикселя
+    std::vector<double> errors;    // С учётом окрестности; по ней решается, нужны ли лучи
+};
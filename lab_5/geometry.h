@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cmath>
+
+// Векторы, лучи и пересечения трассировщика лучей
+// Не зависит от OpenCV: подключается и в замерах производительности
+
+// Структура для векторов и цветов
+// Используется для описания позиций, направлений и цвета
+struct Vec3 {
+    double x, y, z;
+    Vec3(double x_=0, double y_=0, double z_=0) : x(x_), y(y_), z(z_) {}
+
+    Vec3 operator+(const Vec3& v) const { return Vec3(x+v.x, y+v.y, z+v.z); }
+    Vec3 operator-(const Vec3& v) const { return Vec3(x-v.x, y-v.y, z-v.z); }
+    Vec3 operator*(double d) const { return Vec3(x*d, y*d, z*d); }
+    Vec3 operator/(double d) const { return Vec3(x/d, y/d, z/d); }
+
+    // Нормализация вектора (приведение длины к 1)
+    Vec3 normalize() const { double mg = std::sqrt(x*x + y*y + z*z); return Vec3(x/mg, y/mg, z/mg); }
+
+    // Скалярное произведение
+    double dot(const Vec3& v) const { return x*v.x + y*v.y + z*v.z; }
+
+    // Векторное произведение
+    Vec3 cross(const Vec3& v) const { return Vec3(y*v.z - z*v.y, z*v.x - x*v.z, x*v.y - y*v.x); }
+};
+
+// Оператор умножения для скалярного значения * вектор
+inline Vec3 operator*(double d, const Vec3& v) {
+    return Vec3(v.x * d, v.y * d, v.z * d);
+}
+
+// Структура луча
+// Содержит начало и направление луча
+struct Ray {
+    Vec3 origin;      // Точка начала
+    Vec3 direction;   // Направление
+    Ray(const Vec3& o, const Vec3& d) : origin(o), direction(d.normalize()) {}
+};
+
+// Камера интерактивного режима: угол обзора 90 градусов, взгляд вдоль -Z
+struct Camera {
+    Vec3 position; // Позиция камеры
+    int width;     // Ширина изображения
+    int height;    // Высота изображения
+
+    // Луч через точку (x, y) в пиксельных координатах; центр пикселя - (x + 0.5, y + 0.5)
+    Ray primaryRay(double x, double y) const {
+        // Преобразование координат экрана в нормализованные
+        double u = (2.0 * x / static_cast<double>(width) - 1.0) * (width / static_cast<double>(height));
+        double v = 1.0 - 2.0 * y / static_cast<double>(height);
+        return Ray(position, Vec3(u, v, -1));
+    }
+};
+
+// Пересечение луча со сферой; t - ближайшее неотрицательное расстояние
+inline bool intersectSphere(const Vec3& center, double radius, const Ray& ray, double& t) {
+    Vec3 oc = ray.origin - center;
+    double b = 2 * oc.dot(ray.direction);
+    double c = oc.dot(oc) - radius * radius;
+    double discriminant = b*b - 4*c;
+    if (discriminant < 0) return false; // Пересечения нет
+    else {
+        discriminant = std::sqrt(discriminant);
+        double t0 = (-b - discriminant) / 2;
+        double t1 = (-b + discriminant) / 2;
+        t = (t0 < t1) ? t0 : t1;
+        if (t < 0) t = (t0 > t1) ? t0 : t1;
+        return t >= 0;
+    }
+}
+
+// Пересечение луча с плоскостью (normal - единичная нормаль)
+inline bool intersectPlane(const Vec3& point, const Vec3& normal, const Ray& ray, double& t) {
+    double denom = normal.dot(ray.direction);
+    if (std::abs(denom) > 1e-6) { // Луч не параллелен плоскости
+        t = (point - ray.origin).dot(normal) / denom;
+        return t >= 0;
+    }
+    return false;
+}
@@ -0,0 +1,61 @@
+// Преобразование тайлового изображения KGRAW1 (float RGB) в двоичный PPM
+// В памяти одновременно находится только одна строка тайлов.
+//
+// ./raw_to_ppm image.kgraw image.ppm
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "tiled_output.h"
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Использование: " << argv[0] << " вход.kgraw выход.ppm" << std::endl;
+        return -1;
+    }
+
+    TiledImageReader reader(argv[1]);
+    if (!reader.isOpen()) {
+        std::cerr << "Не удалось открыть KGRAW1: " << argv[1] << std::endl;
+        return -1;
+    }
+
+    FILE* out = std::fopen(argv[2], "wb");
+    if (!out) {
+        std::cerr << "Не удалось создать файл: " << argv[2] << std::endl;
+        return -1;
+    }
+    std::fprintf(out, "P6\n%d %d\n255\n", reader.width(), reader.height());
+
+    const int tileSize = reader.tileSize();
+    std::vector<float> band(reader.tileFloats() * reader.tilesX());
+    std::vector<unsigned char> row(size_t(reader.width()) * 3);
+
+    for (int tileY = 0; tileY < reader.tilesY(); ++tileY) {
+        for (int tileX = 0; tileX < reader.tilesX(); ++tileX) {
+            if (!reader.readTile(tileX, tileY, &band[reader.tileFloats() * tileX])) {
+                std::cerr << "Ошибка чтения тайла " << tileX << ", " << tileY << std::endl;
+                std::fclose(out);
+                return -1;
+            }
+        }
+
+        int rows = std::min(tileSize, reader.height() - tileY * tileSize);
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < reader.width(); ++x) {
+                const float* pixel = &band[reader.tileFloats() * (x / tileSize) + (size_t(y) * tileSize + x % tileSize) * 3];
+                // Ограничение цвета в диапазоне [0, 255], как при выводе через OpenCV
+                for (int c = 0; c < 3; ++c)
+                    row[size_t(x) * 3 + c] = static_cast<unsigned char>(std::clamp(pixel[c] * 255.0f, 0.0f, 255.0f));
+            }
+            std::fwrite(row.data(), 1, row.size(), out);
+        }
+    }
+
+    if (std::fclose(out) != 0) {
+        std::cerr << "Ошибка записи: " << argv[2] << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -1,217 +1,20 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
-#include <limits>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
 #include <opencv2/opencv.hpp>
 #include <omp.h>
 
-// Структура для векторов и цветов
-// Используется для описания позиций, направлений и цвета
-struct Vec3 {
-    double x, y, z;
-    Vec3(double x_=0, double y_=0, double z_=0) : x(x_), y(y_), z(z_) {}
-
-    Vec3 operator+(const Vec3& v) const { return Vec3(x+v.x, y+v.y, z+v.z); }
-    Vec3 operator-(const Vec3& v) const { return Vec3(x-v.x, y-v.y, z-v.z); }
-    Vec3 operator*(double d) const { return Vec3(x*d, y*d, z*d); }
-    Vec3 operator/(double d) const { return Vec3(x/d, y/d, z/d); }
-
-    // Нормализация вектора (приведение длины к 1)
-    Vec3 normalize() const { double mg = std::sqrt(x*x + y*y + z*z); return Vec3(x/mg, y/mg, z/mg); }
-
-    // Скалярное произведение
-    double dot(const Vec3& v) const { return x*v.x + y*v.y + z*v.z; }
-
-    // Векторное произведение
-    Vec3 cross(const Vec3& v) const { return Vec3(y*v.z - z*v.y, z*v.x - x*v.z, x*v.y - y*v.x); }
-};
-
-// Оператор умножения для скалярного значения * вектор
-Vec3 operator*(double d, const Vec3& v) {
-    return Vec3(v.x * d, v.y * d, v.z * d);
-}
-
-// Структура луча
-// Содержит начало и направление луча
-struct Ray {
-    Vec3 origin;      // Точка начала
-    Vec3 direction;   // Направление
-    Ray(const Vec3& o, const Vec3& d) : origin(o), direction(d.normalize()) {}
-};
-
-// Абстрактный класс для объектов сцены
-// Определяет интерфейсы для пересечения, получения нормали и цвета
-class Object {
-public:
-    virtual bool intersect(const Ray& ray, double& t) const = 0; // Пересечение луча с объектом
-    virtual Vec3 getNormal(const Vec3& point) const = 0;         // Получение нормали в точке
-    virtual Vec3 getColor(const Vec3& point) const = 0;          // Получение цвета в точке
-    virtual bool isReflective() const = 0;                       // Проверка на отражательность
-    virtual double getReflectivity() const = 0;                  // Коэффициент отражения
-};
-
-// Класс для сферы
-// Реализация объекта-сферы
-class Sphere : public Object {
-public:
-    Vec3 center;          // Центр сферы
-    double radius;        // Радиус
-    Vec3 color;           // Цвет
-    double reflectivity;  // Коэффициент отражения
-
-    Sphere(const Vec3& c, double r, const Vec3& col, double refl) : center(c), radius(r), color(col), reflectivity(refl) {}
-
-    // Проверка пересечения луча со сферой
-    bool intersect(const Ray& ray, double& t) const override {
-        Vec3 oc = ray.origin - center;
-        double b = 2 * oc.dot(ray.direction);
-        double c = oc.dot(oc) - radius * radius;
-        double discriminant = b*b - 4*c;
-        if (discriminant < 0) return false; // Пересечения нет
-        else {
-            discriminant = std::sqrt(discriminant);
-            double t0 = (-b - discriminant) / 2;
-            double t1 = (-b + discriminant) / 2;
-            t = (t0 < t1) ? t0 : t1;
-            if (t < 0) t = (t0 > t1) ? t0 : t1;
-            return t >= 0;
-        }
-    }
-
-    // Нормаль к поверхности сферы
-    Vec3 getNormal(const Vec3& point) const override {
-        return (point - center).normalize();
-    }
-
-    // Цвет сферы
-    Vec3 getColor(const Vec3& point) const override {
-        return color;
-    }
-
-    // Проверка, отражает ли объект
-    bool isReflective() const override {
-        return reflectivity > 0;
-    }
-
-    // Коэффициент отражения
-    double getReflectivity() const override {
-        return reflectivity;
-    }
-
-    // Установка коэффициента отражения
-    void setReflectivity(double refl) {
-        reflectivity = refl;
-    }
-};
-
-// Класс для плоскости
-// Реализация объекта-плоскости с поддержкой текстур
-class Plane : public Object {
-public:
-    Vec3 point;      // Точка на плоскости
-    Vec3 normal;     // Нормаль к плоскости
-    cv::Mat texture; // Текстура плоскости
-    double scale;    // Масштаб текстуры
-    bool reflective; // Флаг отражательной способности
-
-    Plane(const Vec3& p, const Vec3& n, const cv::Mat& tex, double s, bool refl = false) :
-        point(p), normal(n), texture(tex), scale(s), reflective(refl) {
-            normal = normal.normalize();
-        }
-
-    // Проверка пересечения луча с плоскостью
-    bool intersect(const Ray& ray, double& t) const override {
-        double denom = normal.dot(ray.direction);
-        if (std::abs(denom) > 1e-6) { // Луч не параллелен плоскости
-            t = (point - ray.origin).dot(normal) / denom;
-            return t >= 0;
-        }
-        return false;
-    }
-
-    // Нормаль к плоскости
-    Vec3 getNormal(const Vec3& point_) const override {
-        return normal;
-    }
-
-    // Получение цвета текстуры по координатам
-    Vec3 getColor(const Vec3& point_) const override {
-        // Вычисление UV-координат
-        double u, v;
-        if (std::abs(normal.y) > 0.999) { // Горизонтальная плоскость
-            u = point_.x * scale;
-            v = point_.z * scale;
-        } else if (std::abs(normal.z) > 0.999) { // Вертикальная плоскость
-            u = point_.x * scale;
-            v = point_.y * scale;
-        } else {
-            u = 0;
-            v = 0;
-        }
-
-        // Преобразование в координаты текстуры
-        u = u - std::floor(u);
-        v = v - std::floor(v);
-
-        int tex_u = static_cast<int>(u * texture.cols);
-        int tex_v = static_cast<int>(v * texture.rows);
-
-        // Обработка выхода за границы
-        tex_u = std::clamp(tex_u, 0, texture.cols - 1);
-        tex_v = std::clamp(tex_v, 0, texture.rows - 1);
-
-        // Получение цвета из текстуры
-        cv::Vec3b color = texture.at<cv::Vec3b>(tex_v, tex_u);
-        return Vec3(color[2] / 255.0, color[1] / 255.0, color[0] / 255.0);
-    }
-
-    // Проверка, является ли объект отражающим
-    bool isReflective() const override {
-        return reflective;
-    }
-
-    // Коэффициент отражения (не используется для плоскости)
-    double getReflectivity() const override {
-        return 0;
-    }
-};
-
-// Функция трассировки луча
-// Определяет цвет пикселя на основе пересечения с объектами
-Vec3 trace(const Ray& ray, const std::vector<Object*>& objects, int depth) {
-    if (depth <= 0) return Vec3(0, 0, 0); // Ограничение глубины рекурсии для предотвращения бесконечных отражений
-
-    double closest_t = std::numeric_limits<double>::max(); // Инициализация ближайшего расстояния
-    const Object* hit_object = nullptr; // Объект, с которым произошло пересечение
-
-    // Проверка пересечения луча со всеми объектами сцены
-    for (const auto& object : objects) {
-        double t = 0;
-        if (object->intersect(ray, t) && t < closest_t) {
-            closest_t = t;
-            hit_object = object;
-        }
-    }
-
-    if (!hit_object) {
-        return Vec3(0.5, 0.7, 1.0); // Фон (голубой цвет)
-    }
-
-    // Точка пересечения
-    Vec3 hit_point = ray.origin + ray.direction * closest_t;
-    Vec3 normal = hit_object->getNormal(hit_point); // Нормаль в точке пересечения
-    Vec3 color = hit_object->getColor(hit_point);   // Цвет объекта
-
-    // Обработка отражений
-    if (hit_object->isReflective()) {
-        Vec3 reflect_dir = ray.direction - 2 * ray.direction.dot(normal) * normal; // Вычисление отраженного направления
-        Ray reflected_ray(hit_point + reflect_dir * 1e-4, reflect_dir); // Смещение для предотвращения самопересечения
-        Vec3 reflected_color = trace(reflected_ray, objects, depth - 1); // Рекурсивный вызов для отражения
-        color = color * (1 - hit_object->getReflectivity()) + reflected_color * hit_object->getReflectivity(); // Смешивание цветов
-    }
-
-    return color;
-}
+#include "adaptive_sampler.h"
+#include "raytracer.h"
+#include "render_server.h"
+#include "tiled_output.h"
+#include "trace_kernels.h"
 
 // Функция для отрисовки сцены
 // Создает изображение, трассируя лучи для каждого пикселя
@@ -251,58 +54,313 @@ void render(int width, int height, const std::vector<Object*>& objects, const st
     cv::imwrite(output_file, image);
 }
 
-int main() {
+// Отрисовка по тайлам с записью каждого готового тайла в файл KGRAW1
+// В памяти находится по одному тайлу на поток, поэтому расход памяти не зависит
+// от разрешения. Цвет накапливается во float по samplesPerAxis^2 лучам на пиксель.
+bool renderTiled(const Camera& camera, const CompiledScene& tracer, const std::string& output_file,
+                 int tileSize, int samplesPerAxis) {
+    TiledImageWriter writer(output_file, camera.width, camera.height, tileSize);
+    if (!writer.isOpen()) {
+        std::cerr << "Ошибка: Не удалось создать файл " << output_file << std::endl;
+        return false;
+    }
+
+    const int tileCount = writer.tilesX() * writer.tilesY();
+    const float sampleWeight = 1.0f / (samplesPerAxis * samplesPerAxis);
+    std::atomic<int> finishedTiles(0);
+    std::atomic<bool> ok(true);
+    auto start = std::chrono::steady_clock::now();
+
+    std::cout << camera.width << "x" << camera.height << ", тайлов: " << tileCount
+              << ", потоков: " << omp_get_max_threads() << ", память под тайлы: "
+              << omp_get_max_threads() * writer.tileFloats() * sizeof(float) / (1024.0 * 1024.0) << " МБ" << std::endl;
+
+    #pragma omp parallel
+    {
+        std::vector<float> tile(writer.tileFloats()); // Буфер тайла, свой у каждого потока
+
+        #pragma omp for schedule(dynamic)
+        for (int index = 0; index < tileCount; ++index) {
+            int tileX = index % writer.tilesX();
+            int tileY = index / writer.tilesX();
+            int x0 = tileX * tileSize, y0 = tileY * tileSize;
+            int x1 = std::min(x0 + tileSize, camera.width), y1 = std::min(y0 + tileSize, camera.height);
+
+            std::fill(tile.begin(), tile.end(), 0.0f);
+            for (int y = y0; y < y1; ++y) {
+                for (int x = x0; x < x1; ++x) {
+                    float* pixel = &tile[(size_t(y - y0) * tileSize + (x - x0)) * 3];
+                    // Равномерная сетка лучей внутри пикселя
+                    for (int sy = 0; sy < samplesPerAxis; ++sy) {
+                        for (int sx = 0; sx < samplesPerAxis; ++sx) {
+                            Ray ray = camera.primaryRay(x + (sx + 0.5) / samplesPerAxis, y + (sy + 0.5) / samplesPerAxis);
+                            Vec3 color = tracer(ray);
+                            pixel[0] += static_cast<float>(color.x) * sampleWeight;
+                            pixel[1] += static_cast<float>(color.y) * sampleWeight;
+                            pixel[2] += static_cast<float>(color.z) * sampleWeight;
+                        }
+                    }
+                }
+            }
+
+            if (!writer.writeTile(tileX, tileY, tile.data()))
+                ok = false;
+
+            int finished = ++finishedTiles;
+            if (finished % std::max(tileCount / 20, 1) == 0 || finished == tileCount) {
+                #pragma omp critical
+                std::cout << "Готово тайлов: " << finished << " из " << tileCount << std::endl;
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Время: " << seconds << " с, лучей в секунду: "
+              << double(camera.width) * camera.height * samplesPerAxis * samplesPerAxis / seconds << std::endl;
+    if (!ok)
+        std::cerr << "Ошибка записи в " << output_file << std::endl;
+    return ok;
+}
+
+// Ошибка изображения относительно эталона в единицах 8-битного цвета
+struct ImageError {
+    double rmse; // Среднеквадратичная
+    double p99;  // 99-й перцентиль по пикселям (наибольший канал) - заметные ступеньки на краях
+};
+
+// Сравнение адаптивной выборки с равномерной сеткой: ./raytracing --bench-adaptive [ширина высота [x y z камеры]]
+// Для каждого порога адаптивной выборки выводятся её ошибка и число лучей, а также
+// наименьшие равномерные сетки с той же или меньшей ошибкой и число их лучей.
+void benchAdaptive(const CompiledScene& tracer, const Camera& camera) {
+    const int width = camera.width, height = camera.height;
+    const double pixels = double(width) * height;
+
+    // Эталон - 24x24 лучей на пиксель со случайным сдвигом внутри каждой ячейки: он не
+    // совпадает по положению лучей ни с равномерной сеткой, ни с адаптивной выборкой
+    const int referenceAxis = 24;
+    std::vector<Vec3> reference(size_t(width) * height);
+    #pragma omp parallel for schedule(dynamic)
+    for (int y = 0; y < height; ++y) {
+        std::mt19937 random(y);
+        std::uniform_real_distribution<double> jitter(0.0, 1.0);
+        for (int x = 0; x < width; ++x) {
+            Vec3 sum;
+            for (int sy = 0; sy < referenceAxis; ++sy)
+                for (int sx = 0; sx < referenceAxis; ++sx)
+                    sum = sum + tracer(camera.primaryRay(x + (sx + jitter(random)) / referenceAxis,
+                                                         y + (sy + jitter(random)) / referenceAxis));
+            reference[size_t(y) * width + x] = sum / (referenceAxis * referenceAxis);
+        }
+    }
+
+    auto measure = [&](auto colorAt) {
+        double sum = 0;
+        std::vector<double> worst(size_t(width) * height);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                Vec3 d = colorAt(x, y) - reference[size_t(y) * width + x];
+                sum += d.dot(d);
+                worst[size_t(y) * width + x] = std::max({std::abs(d.x), std::abs(d.y), std::abs(d.z)});
+            }
+        }
+        auto p99 = worst.begin() + static_cast<size_t>(worst.size() * 0.99);
+        std::nth_element(worst.begin(), p99, worst.end());
+        return ImageError{std::sqrt(sum / (pixels * 3)) * 255.0, *p99 * 255.0};
+    };
+
+    std::printf("%dx%d, камера (%g, %g, %g), эталон: %dx%d лучей на пиксель\n", width, height, camera.position.x,
+                camera.position.y, camera.position.z, referenceAxis, referenceAxis);
+    std::printf("Равномерная сетка:\n");
+    const int maxAxis = 8;
+    std::vector<ImageError> uniform(maxAxis + 1);
+    for (int axis = 1; axis <= maxAxis; ++axis) {
+        std::vector<Vec3> image(size_t(width) * height);
+        #pragma omp parallel for schedule(dynamic)
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                image[size_t(y) * width + x] = samplePixel(camera, tracer, x, y, axis);
+        uniform[axis] = measure([&](int x, int y) { return image[size_t(y) * width + x]; });
+        std::printf("  %dx%d: %5.1f лучей/пикс, RMSE %6.3f, p99 %6.2f\n", axis, axis, double(axis * axis),
+                    uniform[axis].rmse, uniform[axis].p99);
+    }
+
+    // Число лучей на пиксель, при котором у равномерной сетки ошибка error() равна target:
+    // линейная интерполяция логарифма ошибки по логарифму числа лучей между соседними сетками
+    auto printMatch = [&](const char* name, auto error, double target, double perPixel) {
+        int axis = 1;
+        while (axis <= maxAxis && error(uniform[axis]) > target)
+            ++axis;
+        if (axis > maxAxis) {
+            std::printf("    по %s: сетка до %dx%d такой ошибки не достигает\n", name, maxAxis, maxAxis);
+            return;
+        }
+        double samples = axis * axis;
+        if (axis > 1) {
+            double e0 = std::log(error(uniform[axis - 1])), e1 = std::log(error(uniform[axis]));
+            double s0 = std::log(double((axis - 1) * (axis - 1))), s1 = std::log(samples);
+            samples = std::exp(s0 + (s1 - s0) * (e0 - std::log(target)) / (e0 - e1));
+        }
+        std::printf("    по %s: равномерной сетке нужно %.1f лучей/пикс, в %.2f раза больше\n", name, samples,
+                    samples / perPixel);
+    };
+
+    AdaptiveSettings settings;
+    std::printf("Адаптивная выборка (%d луча в первом проходе, до %d):\n", settings.initialSamples, settings.maxSamples);
+    for (double threshold : {0.04, 0.02, 0.01, 0.005}) {
+        settings.threshold = threshold;
+        AdaptiveSampler sampler(width, height, settings);
+        AdaptiveStats stats = sampler.render(camera, tracer);
+        ImageError error = measure([&](int x, int y) { return sampler.pixel(x, y).mean; });
+        double perPixel = stats.samples / pixels;
+        std::printf("  порог %.3f: %5.1f лучей/пикс, RMSE %6.3f, p99 %6.2f, проходов %d, %.2f с\n", threshold, perPixel,
+                    error.rmse, error.p99, stats.passes, stats.seconds);
+        printMatch("RMSE", [](const ImageError& e) { return e.rmse; }, error.rmse, perPixel);
+        printMatch("p99", [](const ImageError& e) { return e.p99; }, error.p99, perPixel);
+    }
+}
+
+// Сравнение общего trace() со специализированным ядром: ./raytracing --bench-kernels [ширина высота кадров]
+// Кадры отрисовываются с зеркальной и с матовой сферой; выводится время, скорость
+// и наибольшее расхождение цвета пикселя между двумя способами (должно быть 0).
+// Возвращает false, если расхождение не нулевое (используется эталонными тестами).
+bool benchKernels(Scene& scene, int width, int height, int frames) {
+    Camera camera{Vec3(0, 1, 5), width, height};
+    std::vector<Vec3> reference(size_t(width) * height), specialized(size_t(width) * height);
+
+    // Время кадра в мс (лучший из frames) для tracer(ray)
+    auto timeFrames = [&](auto&& tracer, std::vector<Vec3>& pixels) {
+        double best = std::numeric_limits<double>::max();
+        for (int frame = 0; frame < frames; ++frame) {
+            auto start = std::chrono::steady_clock::now();
+            #pragma omp parallel for schedule(dynamic)
+            for (int y = 0; y < height; ++y)
+                for (int x = 0; x < width; ++x)
+                    pixels[size_t(y) * width + x] = tracer(camera.primaryRay(x + 0.5, y + 0.5));
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    };
+
+    std::cout << width << "x" << height << ", кадров: " << frames << ", потоков: " << omp_get_max_threads() << std::endl;
+    bool identical = true;
+    for (double reflectivity : {0.5, 0.0}) {
+        scene.sphere->setReflectivity(reflectivity);
+        CompiledScene compiled(scene.objects, 5);
+        double genericMs = timeFrames([&](const Ray& ray) { return trace(ray, scene.objects, 5); }, reference);
+        double kernelMs = timeFrames(compiled, specialized);
+
+        double maxDifference = 0;
+        for (size_t i = 0; i < reference.size(); ++i) {
+            maxDifference = std::max({maxDifference, std::abs(reference[i].x - specialized[i].x),
+                                      std::abs(reference[i].y - specialized[i].y), std::abs(reference[i].z - specialized[i].z)});
+        }
+        double rays = double(width) * height;
+        std::printf("Зеркальность %.1f (%s)\n", reflectivity, compiled.describe().c_str());
+        std::printf("  trace():  %8.2f мс/кадр, %6.2f Мпикс/с\n", genericMs, rays / genericMs / 1e3);
+        std::printf("  ядро:     %8.2f мс/кадр, %6.2f Мпикс/с, ускорение %.2fx, расхождение %g\n",
+                    kernelMs, rays / kernelMs / 1e3, genericMs / kernelMs, maxDifference);
+        identical = identical && maxDifference == 0;
+    }
+    return identical;
+}
+
+int main(int argc, char** argv) {
     // Параметры сцены
     int width = 800;  // Ширина изображения
     int height = 600; // Высота изображения
 
-    // Загрузка текстуры для плоскости
-    cv::Mat walltexture = cv::imread("wall.jpg");
-    cv::Mat floortexture = cv::imread("flour.jpg");
-    if (walltexture.empty() || floortexture.empty()) {
+    // Сравнение ядер трассировки: ./raytracing --bench-kernels [ширина высота кадров]
+    bool benchMode = argc >= 2 && std::string(argv[1]) == "--bench-kernels";
+
+    // Адаптивная выборка против равномерной: ./raytracing --bench-adaptive [ширина высота [x y z камеры]]
+    bool adaptiveBenchMode = argc >= 2 && std::string(argv[1]) == "--bench-adaptive";
+
+    // Сервер отрисовки: ./raytracing --server [сокет] [потоков]
+    bool serverMode = argc >= 2 && std::string(argv[1]) == "--server";
+
+    // Режим без окна: ./raytracing --tiled ширина высота файл.kgraw [тайл] [лучей_на_ось]
+    bool tiledMode = argc >= 5 && std::string(argv[1]) == "--tiled";
+    std::string tiledOutput;
+    int tileSize = 256;
+    int samplesPerAxis = 1;
+    if (tiledMode) {
+        width = std::atoi(argv[2]);
+        height = std::atoi(argv[3]);
+        tiledOutput = argv[4];
+        if (argc > 5)
+            tileSize = std::atoi(argv[5]);
+        if (argc > 6)
+            samplesPerAxis = std::atoi(argv[6]);
+        if (width <= 0 || height <= 0 || tileSize <= 0 || samplesPerAxis <= 0) {
+            std::cerr << "Ошибка: неверные параметры режима --tiled" << std::endl;
+            return -1;
+        }
+    }
+
+    // Загрузка текстур и создание объектов сцены
+    Scene scene;
+    if (!loadScene(scene)) {
         std::cerr << "Ошибка: Не удалось загрузить текстуры." << std::endl;
         return -1;
     }
+    const std::vector<Object*>& objects = scene.objects;
+    Sphere* sphere = scene.sphere;
+
+    if (benchMode) {
+        bool identical = benchKernels(scene, argc > 3 ? std::atoi(argv[2]) : 800, argc > 3 ? std::atoi(argv[3]) : 600,
+                                      argc > 4 ? std::max(1, std::atoi(argv[4])) : 5);
+        return identical ? 0 : -1;
+    }
+
+    // Сцена для специализированного ядра трассировки (глубина рекурсии = 5);
+    // пересобирается при изменении материалов
+    CompiledScene compiled(objects, 5);
+    std::cout << "Трассировка: " << compiled.describe() << std::endl;
 
-    // Создание объектов сцены
-    std::vector<Object*> objects;
+    // Параметры камеры
+    Vec3 cameraPos(0, 1, 5); // Начальная позиция камеры
+    double cameraSpeed = 0.2; // Скорость перемещения камеры
 
-    // Параметры текстур и материалов
-    Plane* floorPlane = new Plane(Vec3(0, 0, 0), Vec3(0, 1, 0), floortexture, 0.1); // Пол
-    objects.push_back(floorPlane);
+    if (adaptiveBenchMode) {
+        Camera camera{cameraPos, argc > 3 ? std::atoi(argv[2]) : 400, argc > 3 ? std::atoi(argv[3]) : 300};
+        if (argc > 6)
+            camera.position = Vec3(std::atof(argv[4]), std::atof(argv[5]), std::atof(argv[6]));
+        benchAdaptive(compiled, camera);
+        return 0;
+    }
 
-    Plane* wallPlane = new Plane(Vec3(0, 0, -5), Vec3(0, 0, 1), walltexture, 0.1); // Задняя стена
-    objects.push_back(wallPlane);
+    if (tiledMode) {
+        bool ok = renderTiled(Camera{cameraPos, width, height}, compiled, tiledOutput, tileSize, samplesPerAxis);
+        return ok ? 0 : -1;
+    }
 
-    double sphereReflectivity = 0.5; // Начальная зеркальность сферы
-    Sphere* sphere = new Sphere(Vec3(0, 1, 0), 1, Vec3(1, 1, 1), sphereReflectivity); // Сфера
-    objects.push_back(sphere);
+    if (serverMode) {
+        // Сцена, текстуры и потоки загружаются один раз и обслуживают все запросы
+        RenderServer server(compiled, argc > 3 ? std::atoi(argv[3]) : 0);
+        if (!server.listen(argc > 2 ? argv[2] : RENDER_SOCKET_PATH))
+            return -1;
+        installRenderServerSignals();
+        server.run();
+        return 0;
+    }
 
     // Создание окна для визуализации
     cv::namedWindow("Ray Tracing", cv::WINDOW_AUTOSIZE);
 
-    // Параметры камеры
-    Vec3 cameraPos(0, 1, 5); // Начальная позиция камеры
-    double cameraSpeed = 0.2; // Скорость перемещения камеры
-
     // Основной цикл рендеринга
     bool running = true;
     while (running) {
         cv::Mat image(height, width, CV_8UC3); // Матрица для хранения изображения
+        Camera camera{cameraPos, width, height};
 
         // Трассировка лучей
         #pragma omp parallel for schedule(dynamic) // Параллельная обработка
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
-                // Преобразование координат экрана в нормализованные
-                double u = (2.0 * (x + 0.5) / static_cast<double>(width) - 1.0) * (width / static_cast<double>(height));
-                double v = 1.0 - 2.0 * (y + 0.5) / static_cast<double>(height);
-
-                Vec3 dir = Vec3(u, v, -1).normalize(); // Направление луча
-                Ray ray(cameraPos, dir); // Луч из текущей позиции камеры
+                Ray ray = camera.primaryRay(x + 0.5, y + 0.5); // Луч из текущей позиции камеры
 
                 // Вычисление цвета пикселя
-                Vec3 color = trace(ray, objects, 5); // Глубина рекурсии = 5
+                Vec3 color = compiled(ray);
 
                 // Ограничение цвета в диапазоне [0, 255]
                 image.at<cv::Vec3b>(y, x) = cv::Vec3b(
@@ -343,24 +401,40 @@ int main() {
                 break;
             case '+': case '=': // Увеличение зеркальности сферы
                 sphere->setReflectivity(std::min(1.0, sphere->getReflectivity() + 0.1));
+                compiled = CompiledScene(objects, 5);
                 break;
             case '-': // Уменьшение зеркальности сферы
                 sphere->setReflectivity(std::max(0.0, sphere->getReflectivity() - 0.1));
+                compiled = CompiledScene(objects, 5);
                 break;
             case ' ': // Сохранение изображения
                 cv::imwrite("result.png", image);
                 std::cout << "Изображение сохранено в 'result.png'" << std::endl;
                 break;
+            case 'f': case 'F': { // Сохранение сглаженного изображения (адаптивная выборка)
+                AdaptiveSampler sampler(width, height);
+                AdaptiveStats stats = sampler.render(Camera{cameraPos, width, height}, compiled);
+                cv::Mat smooth(height, width, CV_8UC3);
+                for (int y = 0; y < height; ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        Vec3 color = sampler.pixel(x, y).mean;
+                        smooth.at<cv::Vec3b>(y, x) = cv::Vec3b(
+                            static_cast<uchar>(std::clamp(color.z * 255.0, 0.0, 255.0)),
+                            static_cast<uchar>(std::clamp(color.y * 255.0, 0.0, 255.0)),
+                            static_cast<uchar>(std::clamp(color.x * 255.0, 0.0, 255.0))
+                        );
+                    }
+                }
+                cv::imwrite("result_aa.png", smooth);
+                std::cout << "Сглаженное изображение сохранено в 'result_aa.png': " << stats.samples / double(width * height)
+                          << " лучей на пиксель, " << stats.seconds << " с" << std::endl;
+                break;
+            }
             default:
                 break;
         }
     }
 
-    // Очистка памяти
-    for (auto obj : objects) {
-        delete obj;
-    }
-
     cv::destroyAllWindows();
     return 0;
 }
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "geometry.h"
+
+// Абстрактный класс для объектов сцены
+// Определяет интерфейсы для пересечения, получения нормали и цвета
+class Object {
+public:
+    virtual ~Object() = default;
+    virtual bool intersect(const Ray& ray, double& t) const = 0; // Пересечение луча с объектом
+    virtual Vec3 getNormal(const Vec3& point) const = 0;         // Получение нормали в точке
+    virtual Vec3 getColor(const Vec3& point) const = 0;          // Получение цвета в точке
+    virtual bool isReflective() const = 0;                       // Проверка на отражательность
+    virtual double getReflectivity() const = 0;                  // Коэффициент отражения
+};
+
+// Класс для сферы
+// Реализация объекта-сферы
+class Sphere : public Object {
+public:
+    Vec3 center;          // Центр сферы
+    double radius;        // Радиус
+    Vec3 color;           // Цвет
+    double reflectivity;  // Коэффициент отражения
+
+    Sphere(const Vec3& c, double r, const Vec3& col, double refl) : center(c), radius(r), color(col), reflectivity(refl) {}
+
+    // Проверка пересечения луча со сферой
+    bool intersect(const Ray& ray, double& t) const override {
+        return intersectSphere(center, radius, ray, t);
+    }
+
+    // Нормаль к поверхности сферы
+    Vec3 getNormal(const Vec3& point) const override {
+        return (point - center).normalize();
+    }
+
+    // Цвет сферы
+    Vec3 getColor(const Vec3& point) const override {
+        return color;
+    }
+
+    // Проверка, отражает ли объект
+    bool isReflective() const override {
+        return reflectivity > 0;
+    }
+
+    // Коэффициент отражения
+    double getReflectivity() const override {
+        return reflectivity;
+    }
+
+    // Установка коэффициента отражения
+    void setReflectivity(double refl) {
+        reflectivity = refl;
+    }
+};
+
+// Класс для плоскости
+// Реализация объекта-плоскости с поддержкой текстур
+class Plane : public Object {
+public:
+    Vec3 point;      // Точка на плоскости
+    Vec3 normal;     // Нормаль к плоскости
+    cv::Mat texture; // Текстура плоскости
+    double scale;    // Масштаб текстуры
+    bool reflective; // Флаг отражательной способности
+
+    Plane(const Vec3& p, const Vec3& n, const cv::Mat& tex, double s, bool refl = false) :
+        point(p), normal(n), texture(tex), scale(s), reflective(refl) {
+            normal = normal.normalize();
+        }
+
+    // Проверка пересечения луча с плоскостью
+    bool intersect(const Ray& ray, double& t) const override {
+        return intersectPlane(point, normal, ray, t);
+    }
+
+    // Нормаль к плоскости
+    Vec3 getNormal(const Vec3& point_) const override {
+        return normal;
+    }
+
+    // Получение цвета текстуры по координатам
+    Vec3 getColor(const Vec3& point_) const override {
+        if (texture.empty())
+            return Vec3(1, 1, 1); // Плоскость без текстуры - белая
+
+        // Вычисление UV-координат
+        double u, v;
+        if (std::abs(normal.y) > 0.999) { // Горизонтальная плоскость
+            u = point_.x * scale;
+            v = point_.z * scale;
+        } else if (std::abs(normal.z) > 0.999) { // Вертикальная плоскость
+            u = point_.x * scale;
+            v = point_.y * scale;
+        } else {
+            u = 0;
+            v = 0;
+        }
+
+        // Преобразование в координаты текстуры
+        u = u - std::floor(u);
+        v = v - std::floor(v);
+
+        int tex_u = static_cast<int>(u * texture.cols);
+        int tex_v = static_cast<int>(v * texture.rows);
+
+        // Обработка выхода за границы
+        tex_u = std::clamp(tex_u, 0, texture.cols - 1);
+        tex_v = std::clamp(tex_v, 0, texture.rows - 1);
+
+        // Получение цвета из текстуры
+        cv::Vec3b color = texture.at<cv::Vec3b>(tex_v, tex_u);
+        return Vec3(color[2] / 255.0, color[1] / 255.0, color[0] / 255.0);
+    }
+
+    // Проверка, является ли объект отражающим
+    bool isReflective() const override {
+        return reflective;
+    }
+
+    // Коэффициент отражения (не используется для плоскости)
+    double getReflectivity() const override {
+        return 0;
+    }
+};
+
+// Функция трассировки луча
+// Определяет цвет пикселя на основе пересечения с объектами
+inline Vec3 trace(const Ray& ray, const std::vector<Object*>& objects, int depth) {
+    if (depth <= 0) return Vec3(0, 0, 0); // Ограничение глубины рекурсии для предотвращения бесконечных отражений
+
+    double closest_t = std::numeric_limits<double>::max(); // Инициализация ближайшего расстояния
+    const Object* hit_object = nullptr; // Объект, с которым произошло пересечение
+
+    // Проверка пересечения луча со всеми объектами сцены
+    for (const auto& object : objects) {
+        double t = 0;
+        if (object->intersect(ray, t) && t < closest_t) {
+            closest_t = t;
+            hit_object = object;
+        }
+    }
+
+    if (!hit_object) {
+        return Vec3(0.5, 0.7, 1.0); // Фон (голубой цвет)
+    }
+
+    // Точка пересечения
+    Vec3 hit_point = ray.origin + ray.direction * closest_t;
+    Vec3 normal = hit_object->getNormal(hit_point); // Нормаль в точке пересечения
+    Vec3 color = hit_object->getColor(hit_point);   // Цвет объекта
+
+    // Обработка отражений
+    if (hit_object->isReflective()) {
+        Vec3 reflect_dir = ray.direction - 2 * ray.direction.dot(normal) * normal; // Вычисление отраженного направления
+        Ray reflected_ray(hit_point + reflect_dir * 1e-4, reflect_dir); // Смещение для предотвращения самопересечения
+        Vec3 reflected_color = trace(reflected_ray, objects, depth - 1); // Рекурсивный вызов для отражения
+        color = color * (1 - hit_object->getReflectivity()) + reflected_color * hit_object->getReflectivity(); // Смешивание цветов
+    }
+
+    return color;
+}
+
+// Средний цвет пикселя (x, y) по равномерной сетке samplesPerAxis x samplesPerAxis лучей
+// tracer(ray) возвращает цвет луча (например, CompiledScene из trace_kernels.h)
+template <typename Tracer>
+Vec3 samplePixel(const Camera& camera, const Tracer& tracer, int x, int y, int samplesPerAxis) {
+    Vec3 sum;
+    for (int sy = 0; sy < samplesPerAxis; ++sy) {
+        for (int sx = 0; sx < samplesPerAxis; ++sx) {
+            Ray ray = camera.primaryRay(x + (sx + 0.5) / samplesPerAxis, y + (sy + 0.5) / samplesPerAxis);
+            sum = sum + tracer(ray);
+        }
+    }
+    return sum / (samplesPerAxis * samplesPerAxis);
+}
+
+// Сцена лабораторной: пол, задняя стена и зеркальная сфера
+struct Scene {
+    std::vector<Object*> objects;
+    Sphere* sphere = nullptr; // Сфера, зеркальность которой меняется с клавиатуры
+
+    Scene() = default;
+    ~Scene() {
+        // Очистка памяти
+        for (auto obj : objects) {
+            delete obj;
+        }
+    }
+
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+};
+
+// Загрузка текстур (из текущего каталога) и создание объектов сцены
+inline bool loadScene(Scene& scene, double sphereReflectivity = 0.5) {
+    // Загрузка текстур для плоскостей (декодирование идёт параллельно)
+    auto wallFuture = std::async(std::launch::async, [] { return cv::imread("wall.jpg"); });
+    auto floorFuture = std::async(std::launch::async, [] { return cv::imread("flour.jpg"); });
+    cv::Mat walltexture = wallFuture.get();
+    cv::Mat floortexture = floorFuture.get();
+    if (walltexture.empty() || floortexture.empty())
+        return false;
+
+    // Параметры текстур и материалов
+    Plane* floorPlane = new Plane(Vec3(0, 0, 0), Vec3(0, 1, 0), floortexture, 0.1); // Пол
+    scene.objects.push_back(floorPlane);
+
+    Plane* wallPlane = new Plane(Vec3(0, 0, -5), Vec3(0, 0, 1), walltexture, 0.1); // Задняя стена
+    scene.objects.push_back(wallPlane);
+
+    scene.sphere = new Sphere(Vec3(0, 1, 0), 1, Vec3(1, 1, 1), sphereReflectivity); // Сфера
+    scene.objects.push_back(scene.sphere);
+    return true;
+}
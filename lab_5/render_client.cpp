@@ -0,0 +1,205 @@
+// Нагрузочный клиент сервера отрисовки (./raytracing --server)
+// Несколько потоков-клиентов одновременно отправляют запросы кадров и измеряют
+// задержку каждого; в конце выводятся задержки и пропускная способность.
+//
+// ./render_client [--socket путь] [--clients 4] [--requests 16] [--size 400x300]
+//                 [--samples 1] [--save кадр.ppm] [--shutdown]
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "render_protocol.h"
+
+// Подключение к серверу; -1 при ошибке
+int connectToServer(const std::string& path) {
+    sockaddr_un address;
+    if (!makeSocketAddress(path, address))
+        return -1;
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Результаты одного потока-клиента
+struct ClientResult {
+    std::vector<double> latencies; // мс
+    double queueMs = 0, renderMs = 0;
+    int failed = 0;
+};
+
+int main(int argc, char** argv) {
+    std::string socketPath = RENDER_SOCKET_PATH;
+    int clients = 4, requests = 16, width = 400, height = 300, samples = 1;
+    std::string savePath;
+    bool shutdownServer = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--socket" && hasValue)
+            socketPath = argv[++i];
+        else if (arg == "--clients" && hasValue)
+            clients = std::atoi(argv[++i]);
+        else if (arg == "--requests" && hasValue)
+            requests = std::atoi(argv[++i]);
+        else if (arg == "--size" && hasValue)
+            std::sscanf(argv[++i], "%dx%d", &width, &height);
+        else if (arg == "--samples" && hasValue)
+            samples = std::atoi(argv[++i]);
+        else if (arg == "--save" && hasValue)
+            savePath = argv[++i];
+        else if (arg == "--shutdown")
+            shutdownServer = true;
+        else {
+            std::cerr << "Неизвестный параметр: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    if (shutdownServer) {
+        int fd = connectToServer(socketPath);
+        RenderRequest request = {};
+        request.magic = RENDER_PROTOCOL_MAGIC;
+        request.command = RENDER_SHUTDOWN;
+        RenderReply reply;
+        bool ok = fd >= 0 && writeExact(fd, &request, sizeof(request)) && readExact(fd, &reply, sizeof(reply));
+        if (fd >= 0)
+            ::close(fd);
+        std::cout << (ok ? "Сервер остановлен" : "Не удалось подключиться к серверу") << std::endl;
+        return ok ? 0 : -1;
+    }
+
+    if (clients <= 0 || requests <= 0 || width <= 0 || height <= 0 || samples <= 0) {
+        std::cerr << "Неверные параметры" << std::endl;
+        return -1;
+    }
+
+    const size_t frameBytes = size_t(width) * height * 3;
+    std::vector<ClientResult> results(clients);
+    std::mutex outputMutex;
+
+    auto runClient = [&](int index) {
+        ClientResult& result = results[index];
+        int fd = connectToServer(socketPath);
+        if (fd < 0) {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cerr << "Клиент " << index << ": нет соединения с " << socketPath << std::endl;
+            result.failed = requests;
+            return;
+        }
+
+        // Разделяемая память, в которую сервер пишет кадр
+        std::string shmName = "/kg_render_" + std::to_string(::getpid()) + "_" + std::to_string(index);
+        int shmFd = ::shm_open(shmName.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+        void* pixels = MAP_FAILED;
+        if (shmFd >= 0 && ::ftruncate(shmFd, frameBytes) == 0)
+            pixels = ::mmap(nullptr, frameBytes, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+        if (shmFd >= 0)
+            ::close(shmFd);
+        if (pixels == MAP_FAILED) {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cerr << "Клиент " << index << ": не удалось создать разделяемую память" << std::endl;
+            result.failed = requests;
+            ::shm_unlink(shmName.c_str());
+            ::close(fd);
+            return;
+        }
+
+        for (int r = 0; r < requests; ++r) {
+            // Камера облетает сцену; у разных клиентов разные позиции
+            double angle = 0.3 * r + 1.7 * index;
+            RenderRequest request = {};
+            request.magic = RENDER_PROTOCOL_MAGIC;
+            request.command = RENDER_FRAME;
+            request.width = width;
+            request.height = height;
+            request.samplesPerAxis = samples;
+            request.camera[0] = 1.5 * std::sin(angle);
+            request.camera[1] = 1.0;
+            request.camera[2] = 5.0 + 0.5 * std::cos(angle);
+            std::snprintf(request.shmName, sizeof(request.shmName), "%s", shmName.c_str());
+
+            auto start = std::chrono::steady_clock::now();
+            RenderReply reply;
+            if (!writeExact(fd, &request, sizeof(request)) || !readExact(fd, &reply, sizeof(reply)) ||
+                reply.status != RENDER_OK) {
+                ++result.failed;
+                break;
+            }
+            result.latencies.push_back(
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            result.queueMs += reply.queueMs;
+            result.renderMs += reply.renderMs;
+        }
+
+        // Последний кадр первого клиента можно сохранить для проверки
+        if (index == 0 && !savePath.empty() && !result.latencies.empty()) {
+            if (FILE* out = std::fopen(savePath.c_str(), "wb")) {
+                std::fprintf(out, "P6\n%d %d\n255\n", width, height);
+                std::fwrite(pixels, 1, frameBytes, out);
+                std::fclose(out);
+            }
+        }
+
+        ::munmap(pixels, frameBytes);
+        ::shm_unlink(shmName.c_str());
+        ::close(fd);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; ++i)
+        threads.emplace_back(runClient, i);
+    for (std::thread& thread : threads)
+        thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> latencies;
+    double queueMs = 0, renderMs = 0;
+    int failed = 0;
+    for (const ClientResult& result : results) {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        queueMs += result.queueMs;
+        renderMs += result.renderMs;
+        failed += result.failed;
+    }
+    if (latencies.empty()) {
+        std::cerr << "Ни один запрос не выполнен" << std::endl;
+        return -1;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+    double mean = 0;
+    for (double latency : latencies)
+        mean += latency;
+    mean /= latencies.size();
+    double frames = static_cast<double>(latencies.size());
+
+    std::printf("Клиентов: %d, кадров: %zu (%dx%d, %d луч(ей) на ось), ошибок: %d\n",
+                clients, latencies.size(), width, height, samples * samples, failed);
+    std::printf("Задержка, мс: средняя %.2f, p50 %.2f, p95 %.2f, макс %.2f\n",
+                mean, percentile(0.5), percentile(0.95), latencies.back());
+    std::printf("  из них на сервере: ожидание %.2f, отрисовка %.2f\n", queueMs / frames, renderMs / frames);
+    std::printf("Пропускная способность: %.2f кадров/с, %.2f Мпикс/с\n",
+                frames / seconds, frames * width * height / seconds / 1e6);
+    return failed == 0 ? 0 : -1;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Протокол сервера отрисовки (./raytracing --server)
+//
+// Клиент подключается к Unix-сокету и отправляет RenderRequest, сервер отвечает
+// RenderReply. Пиксели не передаются через сокет: клиент создаёт разделяемую память
+// (shm_open) размером не меньше width * height * 3 байт и передаёт её имя, сервер
+// пишет туда RGB по строкам (8 бит на канал) и отвечает, когда кадр готов.
+// По одному соединению можно отправлять запросы один за другим.
+
+const char* const RENDER_SOCKET_PATH = "/tmp/kg_raytracer.sock"; // Путь сокета по умолчанию
+const uint32_t RENDER_PROTOCOL_MAGIC = 0x5452474b;               // "KGRT"
+
+enum RenderCommand : uint32_t {
+    RENDER_FRAME = 1,    // Отрисовать кадр
+    RENDER_SHUTDOWN = 2, // Остановить сервер
+};
+
+enum RenderStatus : uint32_t {
+    RENDER_OK = 0,
+    RENDER_BAD_REQUEST = 1, // Неверный заголовок или параметры
+    RENDER_SHM_ERROR = 2,   // Не удалось открыть разделяемую память или она слишком мала
+};
+
+struct RenderRequest {
+    uint32_t magic;          // RENDER_PROTOCOL_MAGIC
+    uint32_t command;        // RenderCommand
+    uint32_t width, height;  // Размер кадра
+    uint32_t samplesPerAxis; // Лучей на пиксель по каждой оси
+    uint32_t reserved;
+    double camera[3];        // Позиция камеры
+    char shmName[64];        // Имя разделяемой памяти для пикселей, например "/kg_render_1"
+};
+
+struct RenderReply {
+    uint32_t status;  // RenderStatus
+    uint32_t tiles;   // Число тайлов кадра
+    double queueMs;   // Ожидание от приёма запроса до начала первого тайла
+    double renderMs;  // От начала первого тайла до готовности кадра
+};
+
+// Чтение ровно size байт; false при закрытии соединения или ошибке
+inline bool readExact(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t count = ::recv(fd, bytes, size, 0);
+        if (count <= 0)
+            return false;
+        bytes += count;
+        size -= count;
+    }
+    return true;
+}
+
+// Запись ровно size байт (без SIGPIPE при закрытом соединении)
+inline bool writeExact(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t count = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (count <= 0)
+            return false;
+        bytes += count;
+        size -= count;
+    }
+    return true;
+}
+
+// Адрес Unix-сокета; false, если путь слишком длинный
+inline bool makeSocketAddress(const std::string& path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        return false;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
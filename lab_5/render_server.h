@@ -0,0 +1,308 @@
+#pragma once
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "raytracer.h"
+#include "render_protocol.h"
+#include "trace_kernels.h"
+
+// Флаг остановки по SIGINT/SIGTERM
+inline volatile std::sig_atomic_t renderServerInterrupted = 0;
+
+inline void installRenderServerSignals() {
+    auto handler = [](int) { renderServerInterrupted = 1; };
+    std::signal(SIGINT, handler);
+    std::signal(SIGTERM, handler);
+}
+
+// Сервер отрисовки: сцена и пул потоков живут всё время работы сервера
+// Каждый запрос делится на тайлы; потоки пула берут тайлы из общей очереди
+// запросов по кругу (по одному тайлу от каждого запроса), поэтому одновременные
+// запросы выполняются вместе и маленький кадр не ждёт окончания большого.
+class RenderServer {
+public:
+    RenderServer(const CompiledScene& tracer, int threadCount, int tileSize = 64) : tracer(tracer), tileSize(tileSize) {
+        if (threadCount <= 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        for (int i = 0; i < threadCount; ++i)
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ~RenderServer() {
+        stop();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (std::thread& worker : workers)
+            worker.join();
+        if (listenFd >= 0) {
+            ::close(listenFd);
+            ::unlink(socketPath.c_str());
+        }
+    }
+
+    RenderServer(const RenderServer&) = delete;
+    RenderServer& operator=(const RenderServer&) = delete;
+
+    // Создание сокета; существующий файл сокета заменяется
+    bool listen(const std::string& path) {
+        sockaddr_un address;
+        if (!makeSocketAddress(path, address)) {
+            std::cerr << "Слишком длинный путь сокета: " << path << std::endl;
+            return false;
+        }
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0)
+            return false;
+        ::unlink(path.c_str());
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listenFd, 64) != 0) {
+            std::cerr << "Не удалось открыть сокет: " << path << std::endl;
+            ::close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        socketPath = path;
+        std::cout << "Сервер отрисовки: " << path << ", потоков: " << workers.size()
+                  << ", тайл: " << tileSize << "x" << tileSize << std::endl;
+        return true;
+    }
+
+    // Приём соединений до команды RENDER_SHUTDOWN или сигнала
+    // Потоки закрытых соединений присоединяются на каждом проходе цикла (в том числе
+    // по таймауту poll), поэтому их число не растёт с числом принятых соединений.
+    void run() {
+        std::list<Connection> connections;
+        while (!stopRequested && !renderServerInterrupted) {
+            reapConnections(connections);
+            pollfd descriptor = {listenFd, POLLIN, 0};
+            if (::poll(&descriptor, 1, 200) <= 0)
+                continue;
+            int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0)
+                continue;
+            {
+                std::lock_guard<std::mutex> lock(connectionMutex);
+                openConnections.insert(fd);
+            }
+            Connection& connection = connections.emplace_back();
+            connection.thread = std::thread([this, fd, &connection] {
+                serveConnection(fd);
+                connection.finished = true;
+            });
+        }
+        stop();
+        for (Connection& connection : connections)
+            connection.thread.join();
+
+        std::cout << "Обработано запросов: " << completedRequests << ", мегапикселей: "
+                  << completedPixels / 1e6 << std::endl;
+    }
+
+    // Остановка приёма; открытые соединения закрываются
+    void stop() {
+        stopRequested = true;
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        for (int fd : openConnections)
+            ::shutdown(fd, SHUT_RDWR);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Поток соединения; finished выставляется потоком после закрытия сокета
+    struct Connection {
+        std::thread thread;
+        std::atomic<bool> finished{false};
+    };
+
+    static void reapConnections(std::list<Connection>& connections) {
+        for (auto it = connections.begin(); it != connections.end();) {
+            if (it->finished) {
+                it->thread.join();
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Один кадр, тайлы которого выполняются потоками пула
+    struct Job {
+        Camera camera;
+        int samplesPerAxis;
+        unsigned char* pixels; // RGB в разделяемой памяти клиента
+        int tilesX, tileCount;
+        int nextTile = 0;             // Защищён queueMutex
+        std::atomic<int> remaining{0};
+
+        Clock::time_point submitted, started, finished;
+        std::mutex doneMutex;
+        std::condition_variable doneSignal;
+        bool done = false;
+    };
+
+    void workerLoop() {
+        while (true) {
+            std::shared_ptr<Job> job;
+            int tile;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty())
+                    return;
+                job = jobs.front();
+                jobs.pop_front();
+                tile = job->nextTile++;
+                if (tile == 0)
+                    job->started = Clock::now();
+                // Остальные тайлы запроса - в конец очереди, после тайлов других запросов
+                if (job->nextTile < job->tileCount)
+                    jobs.push_back(job);
+            }
+
+            renderTile(*job, tile);
+
+            if (--job->remaining == 0) {
+                std::lock_guard<std::mutex> lock(job->doneMutex);
+                job->finished = Clock::now();
+                job->done = true;
+                job->doneSignal.notify_all();
+            }
+        }
+    }
+
+    void renderTile(const Job& job, int tile) {
+        const int width = job.camera.width, height = job.camera.height;
+        int x0 = (tile % job.tilesX) * tileSize, y0 = (tile / job.tilesX) * tileSize;
+        int x1 = std::min(x0 + tileSize, width), y1 = std::min(y0 + tileSize, height);
+        for (int y = y0; y < y1; ++y) {
+            unsigned char* row = job.pixels + size_t(y) * width * 3;
+            for (int x = x0; x < x1; ++x) {
+                Vec3 color = samplePixel(job.camera, tracer, x, y, job.samplesPerAxis);
+                // Ограничение цвета в диапазоне [0, 255]
+                row[x * 3 + 0] = static_cast<unsigned char>(std::clamp(color.x * 255.0, 0.0, 255.0));
+                row[x * 3 + 1] = static_cast<unsigned char>(std::clamp(color.y * 255.0, 0.0, 255.0));
+                row[x * 3 + 2] = static_cast<unsigned char>(std::clamp(color.z * 255.0, 0.0, 255.0));
+            }
+        }
+    }
+
+    void serveConnection(int fd) {
+        RenderRequest request;
+        while (readExact(fd, &request, sizeof(request))) {
+            RenderReply reply = {};
+            if (request.magic != RENDER_PROTOCOL_MAGIC) {
+                reply.status = RENDER_BAD_REQUEST;
+                writeExact(fd, &reply, sizeof(reply));
+                break;
+            }
+            if (request.command == RENDER_SHUTDOWN) {
+                reply.status = RENDER_OK;
+                writeExact(fd, &reply, sizeof(reply));
+                stopRequested = true;
+                break;
+            }
+            reply = renderFrame(request);
+            if (!writeExact(fd, &reply, sizeof(reply)))
+                break;
+        }
+
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        openConnections.erase(fd);
+        ::close(fd);
+    }
+
+    RenderReply renderFrame(RenderRequest& request) {
+        RenderReply reply = {};
+        if (request.command != RENDER_FRAME || request.width == 0 || request.height == 0 ||
+            request.width > 65536 || request.height > 65536 || request.samplesPerAxis == 0 || request.samplesPerAxis > 16) {
+            reply.status = RENDER_BAD_REQUEST;
+            return reply;
+        }
+
+        // Отображение разделяемой памяти клиента
+        request.shmName[sizeof(request.shmName) - 1] = '\0';
+        size_t size = size_t(request.width) * request.height * 3;
+        int shmFd = ::shm_open(request.shmName, O_RDWR, 0);
+        struct stat info;
+        if (shmFd < 0 || ::fstat(shmFd, &info) != 0 || static_cast<size_t>(info.st_size) < size) {
+            if (shmFd >= 0)
+                ::close(shmFd);
+            reply.status = RENDER_SHM_ERROR;
+            return reply;
+        }
+        void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+        ::close(shmFd);
+        if (mapping == MAP_FAILED) {
+            reply.status = RENDER_SHM_ERROR;
+            return reply;
+        }
+
+        auto job = std::make_shared<Job>();
+        job->camera = Camera{Vec3(request.camera[0], request.camera[1], request.camera[2]),
+                             static_cast<int>(request.width), static_cast<int>(request.height)};
+        job->samplesPerAxis = static_cast<int>(request.samplesPerAxis);
+        job->pixels = static_cast<unsigned char*>(mapping);
+        job->tilesX = (job->camera.width + tileSize - 1) / tileSize;
+        job->tileCount = job->tilesX * ((job->camera.height + tileSize - 1) / tileSize);
+        job->remaining = job->tileCount;
+        job->submitted = Clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            jobs.push_back(job);
+        }
+        queueReady.notify_all();
+
+        {
+            std::unique_lock<std::mutex> lock(job->doneMutex);
+            job->doneSignal.wait(lock, [&job] { return job->done; });
+        }
+        ::munmap(mapping, size);
+
+        ++completedRequests;
+        completedPixels += size / 3;
+        reply.status = RENDER_OK;
+        reply.tiles = job->tileCount;
+        reply.queueMs = std::chrono::duration<double, std::milli>(job->started - job->submitted).count();
+        reply.renderMs = std::chrono::duration<double, std::milli>(job->finished - job->started).count();
+        return reply;
+    }
+
+    const CompiledScene& tracer;
+    const int tileSize;
+
+    std::vector<std::thread> workers;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<std::shared_ptr<Job>> jobs; // Запросы, у которых остались невыданные тайлы
+    bool stopping = false;
+
+    int listenFd = -1;
+    std::string socketPath;
+    std::atomic<bool> stopRequested{false};
+    std::mutex connectionMutex;
+    std::set<int> openConnections;
+
+    std::atomic<long> completedRequests{0};
+    std::atomic<long long> completedPixels{0};
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Изображение в формате KGRAW1: float RGB, разбитое на квадратные тайлы
+//
+// Заголовок (32 байта): "KGRAW1\0\0", ширина, высота, размер тайла, число каналов (uint32),
+// затем 8 байт резерва. Дальше тайлы подряд по строкам тайлов; каждый тайл занимает
+// tileSize * tileSize * 3 float (крайние тайлы дополнены), пиксели внутри тайла - по строкам.
+// Смещение тайла вычисляется по его координатам, поэтому тайлы можно записывать
+// в любом порядке из любых потоков, а в памяти держать только те, что сейчас считаются.
+struct TiledImageHeader {
+    char magic[8];
+    uint32_t width, height;
+    uint32_t tileSize;
+    uint32_t channels;
+    uint32_t reserved[2];
+};
+
+static_assert(sizeof(TiledImageHeader) == 32, "Заголовок KGRAW1 должен занимать 32 байта");
+
+// Общая часть писателя и читателя: геометрия тайлов
+class TiledImageLayout {
+public:
+    int width() const { return static_cast<int>(header.width); }
+    int height() const { return static_cast<int>(header.height); }
+    int tileSize() const { return static_cast<int>(header.tileSize); }
+    int tilesX() const { return (width() + tileSize() - 1) / tileSize(); }
+    int tilesY() const { return (height() + tileSize() - 1) / tileSize(); }
+
+    // Число float в одном тайле
+    size_t tileFloats() const { return size_t(header.tileSize) * header.tileSize * 3; }
+
+    off_t tileOffset(int tileX, int tileY) const {
+        return static_cast<off_t>(sizeof(TiledImageHeader)) +
+               static_cast<off_t>(size_t(tileY) * tilesX() + tileX) * static_cast<off_t>(tileFloats() * sizeof(float));
+    }
+
+protected:
+    TiledImageHeader header = {};
+};
+
+// Запись тайлов в файл через pwrite; безопасна при вызове из нескольких потоков
+class TiledImageWriter : public TiledImageLayout {
+public:
+    TiledImageWriter(const std::string& path, int width, int height, int tileSize) {
+        std::memcpy(header.magic, "KGRAW1\0", 8);
+        header.width = width;
+        header.height = height;
+        header.tileSize = tileSize;
+        header.channels = 3;
+
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return;
+        // Файл сразу получает полный размер (на большинстве ФС - разреженный)
+        off_t size = tileOffset(tilesX() - 1, tilesY() - 1) + static_cast<off_t>(tileFloats() * sizeof(float));
+        if (::ftruncate(fd, size) != 0 || !writeAll(&header, sizeof(header), 0)) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    ~TiledImageWriter() {
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    TiledImageWriter(const TiledImageWriter&) = delete;
+    TiledImageWriter& operator=(const TiledImageWriter&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+
+    // data - tileFloats() значений, строки тайла подряд
+    bool writeTile(int tileX, int tileY, const float* data) {
+        return writeAll(data, tileFloats() * sizeof(float), tileOffset(tileX, tileY));
+    }
+
+private:
+    bool writeAll(const void* data, size_t size, off_t offset) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = ::pwrite(fd, bytes, size, offset);
+            if (written <= 0)
+                return false;
+            bytes += written;
+            size -= written;
+            offset += written;
+        }
+        return true;
+    }
+
+    int fd = -1;
+};
+
+// Чтение тайлов KGRAW1
+class TiledImageReader : public TiledImageLayout {
+public:
+    explicit TiledImageReader(const std::string& path) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        if (!readAll(&header, sizeof(header), 0) || std::memcmp(header.magic, "KGRAW1", 6) != 0 ||
+            header.channels != 3 || header.tileSize == 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    ~TiledImageReader() {
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    TiledImageReader(const TiledImageReader&) = delete;
+    TiledImageReader& operator=(const TiledImageReader&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+
+    bool readTile(int tileX, int tileY, float* data) const {
+        return readAll(data, tileFloats() * sizeof(float), tileOffset(tileX, tileY));
+    }
+
+private:
+    bool readAll(void* data, size_t size, off_t offset) const {
+        char* bytes = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t count = ::pread(fd, bytes, size, offset);
+            if (count <= 0)
+                return false;
+            bytes += count;
+            size -= count;
+            offset += count;
+        }
+        return true;
+    }
+
+    int fd = -1;
+};
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "raytracer.h"
+
+// Специализированные ядра трассировки
+//
+// Общий trace() на каждом пересечении вызывает виртуальные функции, проверяет
+// isReflective() и выбирает формулу UV по ориентации плоскости для каждого texel.
+// Здесь сцена один раз переводится в плоские массивы: сферы отдельно, плоскости
+// сгруппированы по ориентации (горизонтальная / вертикальная / общая) и наличию
+// текстуры, и для каждой группы свои функции пересечения и цвета, у которых
+// ориентация и текстура - параметры шаблона. Само ядро - шаблон по глубине
+// рекурсии и наличию отражающих объектов; подходящий экземпляр выбирается один
+// раз при загрузке сцены (CompiledScene). Результат совпадает с trace() бит в бит.
+
+enum class PlaneOrientation {
+    Horizontal, // Нормаль (0, +-1, 0)
+    Vertical,   // Нормаль (0, 0, +-1)
+    General,    // Любая другая
+};
+
+struct FlatSphere {
+    Vec3 center;
+    double radius;
+    Vec3 color;
+    double reflectivity;
+    size_t order; // Индекс объекта в исходной сцене
+};
+
+// Текстура без обращений к cv::Mat в цикле
+struct FlatTexture {
+    const unsigned char* data = nullptr; // BGR
+    int cols = 0, rows = 0;
+    size_t step = 0; // Байт на строку
+};
+
+struct FlatPlane {
+    Vec3 point;
+    Vec3 normal;
+    FlatTexture texture;
+    double scale;
+    bool reflective;
+    size_t order;
+};
+
+// Группы плоскостей: [ориентация][есть текстура]
+const int PLANE_ORIENTATIONS = 3;
+
+struct FlatScene {
+    std::vector<FlatSphere> spheres;
+    std::vector<FlatPlane> planes[PLANE_ORIENTATIONS][2];
+    std::vector<cv::Mat> textures; // Держат данные текстур, на которые ссылаются FlatTexture
+};
+
+// Пересечение со сферой
+inline bool intersectSphere(const FlatSphere& sphere, const Ray& ray, double& t) {
+    return intersectSphere(sphere.center, sphere.radius, ray, t);
+}
+
+// Пересечение с плоскостью; для осевых нормалей скалярные произведения
+// сокращаются до одной компоненты (остальные слагаемые - точные нули)
+template <PlaneOrientation Orientation>
+bool intersectPlane(const FlatPlane& plane, const Ray& ray, double& t) {
+    double denom;
+    if constexpr (Orientation == PlaneOrientation::Horizontal)
+        denom = plane.normal.y * ray.direction.y;
+    else if constexpr (Orientation == PlaneOrientation::Vertical)
+        denom = plane.normal.z * ray.direction.z;
+    else
+        denom = plane.normal.dot(ray.direction);
+    if (std::abs(denom) > 1e-6) { // Луч не параллелен плоскости
+        if constexpr (Orientation == PlaneOrientation::Horizontal)
+            t = (plane.point.y - ray.origin.y) * plane.normal.y / denom;
+        else if constexpr (Orientation == PlaneOrientation::Vertical)
+            t = (plane.point.z - ray.origin.z) * plane.normal.z / denom;
+        else
+            t = (plane.point - ray.origin).dot(plane.normal) / denom;
+        return t >= 0;
+    }
+    return false;
+}
+
+// Цвет плоскости в точке (те же формулы, что Plane::getColor)
+template <PlaneOrientation Orientation, bool Textured>
+Vec3 planeColor(const FlatPlane& plane, const Vec3& point) {
+    if constexpr (!Textured) {
+        return Vec3(1, 1, 1);
+    } else {
+        // Вычисление UV-координат
+        double u, v;
+        if constexpr (Orientation == PlaneOrientation::Horizontal) {
+            u = point.x * plane.scale;
+            v = point.z * plane.scale;
+        } else if constexpr (Orientation == PlaneOrientation::Vertical) {
+            u = point.x * plane.scale;
+            v = point.y * plane.scale;
+        } else {
+            // Нормаль не строго по оси - выбор формулы остаётся во время выполнения
+            if (std::abs(plane.normal.y) > 0.999) {
+                u = point.x * plane.scale;
+                v = point.z * plane.scale;
+            } else if (std::abs(plane.normal.z) > 0.999) {
+                u = point.x * plane.scale;
+                v = point.y * plane.scale;
+            } else {
+                u = 0;
+                v = 0;
+            }
+        }
+
+        // Преобразование в координаты текстуры
+        u = u - std::floor(u);
+        v = v - std::floor(v);
+        const FlatTexture& texture = plane.texture;
+        int tex_u = std::clamp(static_cast<int>(u * texture.cols), 0, texture.cols - 1);
+        int tex_v = std::clamp(static_cast<int>(v * texture.rows), 0, texture.rows - 1);
+        const unsigned char* color = texture.data + tex_v * texture.step + tex_u * 3;
+        return Vec3(color[2] / 255.0, color[1] / 255.0, color[0] / 255.0);
+    }
+}
+
+// Ближайшее пересечение: kind = 0 - сфера, 1 + orientation * 2 + textured - группа плоскостей
+struct KernelHit {
+    double t = std::numeric_limits<double>::max();
+    int kind = -1;
+    size_t index = 0;
+    size_t order = 0;
+
+    // При равных t побеждает объект, стоящий раньше в сцене, как в trace()
+    bool closer(double candidate, size_t candidateOrder) const {
+        return candidate < t || (candidate == t && candidateOrder < order);
+    }
+};
+
+template <PlaneOrientation Orientation, bool Textured>
+void intersectPlaneGroup(const FlatScene& scene, const Ray& ray, KernelHit& hit) {
+    const std::vector<FlatPlane>& planes = scene.planes[static_cast<int>(Orientation)][Textured];
+    for (size_t i = 0; i < planes.size(); ++i) {
+        double t = 0;
+        if (intersectPlane<Orientation>(planes[i], ray, t) && hit.closer(t, planes[i].order)) {
+            hit.t = t;
+            hit.order = planes[i].order;
+            hit.kind = 1 + static_cast<int>(Orientation) * 2 + Textured;
+            hit.index = i;
+        }
+    }
+}
+
+// Нормаль, цвет и отражательная способность плоскости из группы
+template <PlaneOrientation Orientation, bool Textured>
+void shadePlane(const FlatScene& scene, size_t index, const Vec3& point, Vec3& normal, Vec3& color, bool& reflective) {
+    const FlatPlane& plane = scene.planes[static_cast<int>(Orientation)][Textured][index];
+    normal = plane.normal;
+    color = planeColor<Orientation, Textured>(plane, point);
+    reflective = plane.reflective;
+}
+
+// Ядро трассировки: Depth - оставшаяся глубина рекурсии, AnyReflective - есть ли в сцене отражения
+template <int Depth, bool AnyReflective>
+Vec3 traceKernel(const FlatScene& scene, const Ray& ray) {
+    if constexpr (Depth <= 0) {
+        return Vec3(0, 0, 0); // Ограничение глубины рекурсии
+    } else {
+        KernelHit hit;
+        for (size_t i = 0; i < scene.spheres.size(); ++i) {
+            double t = 0;
+            if (intersectSphere(scene.spheres[i], ray, t) && hit.closer(t, scene.spheres[i].order)) {
+                hit.t = t;
+                hit.order = scene.spheres[i].order;
+                hit.kind = 0;
+                hit.index = i;
+            }
+        }
+        intersectPlaneGroup<PlaneOrientation::Horizontal, true>(scene, ray, hit);
+        intersectPlaneGroup<PlaneOrientation::Horizontal, false>(scene, ray, hit);
+        intersectPlaneGroup<PlaneOrientation::Vertical, true>(scene, ray, hit);
+        intersectPlaneGroup<PlaneOrientation::Vertical, false>(scene, ray, hit);
+        intersectPlaneGroup<PlaneOrientation::General, true>(scene, ray, hit);
+        intersectPlaneGroup<PlaneOrientation::General, false>(scene, ray, hit);
+
+        if (hit.kind < 0) {
+            return Vec3(0.5, 0.7, 1.0); // Фон (голубой цвет)
+        }
+
+        // Точка пересечения
+        Vec3 hit_point = ray.origin + ray.direction * hit.t;
+        Vec3 normal, color;
+        double reflectivity = 0;
+        bool reflective = false;
+        switch (hit.kind) {
+        case 0: {
+            const FlatSphere& sphere = scene.spheres[hit.index];
+            normal = (hit_point - sphere.center).normalize();
+            color = sphere.color;
+            reflectivity = sphere.reflectivity;
+            reflective = reflectivity > 0;
+            break;
+        }
+        case 1: shadePlane<PlaneOrientation::Horizontal, false>(scene, hit.index, hit_point, normal, color, reflective); break;
+        case 2: shadePlane<PlaneOrientation::Horizontal, true>(scene, hit.index, hit_point, normal, color, reflective); break;
+        case 3: shadePlane<PlaneOrientation::Vertical, false>(scene, hit.index, hit_point, normal, color, reflective); break;
+        case 4: shadePlane<PlaneOrientation::Vertical, true>(scene, hit.index, hit_point, normal, color, reflective); break;
+        case 5: shadePlane<PlaneOrientation::General, false>(scene, hit.index, hit_point, normal, color, reflective); break;
+        default: shadePlane<PlaneOrientation::General, true>(scene, hit.index, hit_point, normal, color, reflective); break;
+        }
+
+        // Обработка отражений; у отражающей плоскости коэффициент 0, её цвет не меняется
+        if constexpr (AnyReflective) {
+            if (reflective && reflectivity > 0) {
+                Vec3 reflect_dir = ray.direction - 2 * ray.direction.dot(normal) * normal; // Вычисление отраженного направления
+                Ray reflected_ray(hit_point + reflect_dir * 1e-4, reflect_dir); // Смещение для предотвращения самопересечения
+                Vec3 reflected_color = traceKernel<Depth - 1, AnyReflective>(scene, reflected_ray);
+                color = color * (1 - reflectivity) + reflected_color * reflectivity; // Смешивание цветов
+            }
+        }
+        return color;
+    }
+}
+
+using TraceKernelFn = Vec3 (*)(const FlatScene&, const Ray&);
+
+// Наибольшая глубина, для которой есть специализированные ядра
+const int MAX_KERNEL_DEPTH = 8;
+
+// Выбор ядра из таблицы [глубина - 1][есть отражения]
+template <size_t... Depths>
+TraceKernelFn selectKernel(int depth, bool anyReflective, std::index_sequence<Depths...>) {
+    static const TraceKernelFn table[][2] = {
+        {traceKernel<Depths + 1, false>, traceKernel<Depths + 1, true>}...
+    };
+    return table[depth - 1][anyReflective];
+}
+
+// Сцена, подготовленная для специализированного ядра
+// Функция вызова: compiled(ray) - цвет луча, как trace(ray, objects, maxDepth).
+// Если в сцене есть объекты неизвестных типов или глубина больше MAX_KERNEL_DEPTH,
+// используется общий trace().
+class CompiledScene {
+public:
+    explicit CompiledScene(const std::vector<Object*>& objects, int maxDepth = 5) : objects(&objects), maxDepth(maxDepth) {
+        bool flattened = true;
+        bool anyReflective = false;
+        for (size_t order = 0; order < objects.size(); ++order) {
+            const Object* object = objects[order];
+            if (const Sphere* sphere = dynamic_cast<const Sphere*>(object)) {
+                flat.spheres.push_back({sphere->center, sphere->radius, sphere->color, sphere->reflectivity, order});
+                anyReflective = anyReflective || sphere->isReflective();
+            } else if (const Plane* plane = dynamic_cast<const Plane*>(object)) {
+                FlatPlane flatPlane = {plane->point, plane->normal, FlatTexture(), plane->scale, plane->reflective, order};
+                bool textured = !plane->texture.empty();
+                if (textured) {
+                    flat.textures.push_back(plane->texture);
+                    flatPlane.texture.data = plane->texture.data;
+                    flatPlane.texture.cols = plane->texture.cols;
+                    flatPlane.texture.rows = plane->texture.rows;
+                    flatPlane.texture.step = plane->texture.step[0];
+                }
+                // Коэффициент отражения плоскости равен 0 - отражения она не добавляет
+                flat.planes[static_cast<int>(orientationOf(plane->normal))][textured].push_back(flatPlane);
+            } else {
+                flattened = false;
+            }
+        }
+
+        if (flattened && maxDepth >= 1 && maxDepth <= MAX_KERNEL_DEPTH)
+            kernel = selectKernel(maxDepth, anyReflective, std::make_index_sequence<MAX_KERNEL_DEPTH>());
+        description = kernel ? "ядро: глубина " + std::to_string(maxDepth) + (anyReflective ? ", с отражениями" : ", без отражений")
+                             : std::string("общий trace()");
+        if (kernel) {
+            const char* names[PLANE_ORIENTATIONS] = {"горизонтальных", "вертикальных", "общих"};
+            for (int o = 0; o < PLANE_ORIENTATIONS; ++o)
+                for (int textured = 1; textured >= 0; --textured)
+                    if (!flat.planes[o][textured].empty())
+                        description += ", " + std::to_string(flat.planes[o][textured].size()) + " " + names[o] +
+                                       (textured ? " с текстурой" : " без текстуры");
+        }
+    }
+
+    Vec3 operator()(const Ray& ray) const {
+        return kernel ? kernel(flat, ray) : trace(ray, *objects, maxDepth);
+    }
+
+    bool isSpecialized() const { return kernel != nullptr; }
+    const std::string& describe() const { return description; }
+
+    static PlaneOrientation orientationOf(const Vec3& normal) {
+        if (normal.x == 0 && normal.z == 0)
+            return PlaneOrientation::Horizontal;
+        if (normal.x == 0 && normal.y == 0)
+            return PlaneOrientation::Vertical;
+        return PlaneOrientation::General;
+    }
+
+private:
+    const std::vector<Object*>* objects;
+    int maxDepth;
+    FlatScene flat;
+    TraceKernelFn kernel = nullptr;
+    std::string description;
+};
@@ -0,0 +1,99 @@
+// Сравнение изображения с эталоном (оба в формате PPM P6)
+// Пиксель считается отличающимся, если хотя бы один канал отличается больше чем на
+// --max-diff. Проверка не проходит, если таких пикселей больше доли --max-bad или
+// PSNR ниже --min-psnr.
+//
+// ./image_compare результат.ppm эталон.ppm [--max-diff 2] [--max-bad 0.001] [--min-psnr 40]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct PpmImage {
+    int width = 0, height = 0;
+    std::vector<unsigned char> pixels; // RGB по строкам
+};
+
+// Чтение PPM P6 с максимальным значением 255; false при ошибке
+bool readPPM(const std::string& path, PpmImage& image) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    int maxValue = 0;
+    bool ok = std::fscanf(file, "P6 %d %d %d", &image.width, &image.height, &maxValue) == 3 && maxValue == 255 &&
+              image.width > 0 && image.height > 0 && std::fgetc(file) != EOF; // Один пробельный символ после заголовка
+    if (ok) {
+        image.pixels.resize(size_t(image.width) * image.height * 3);
+        ok = std::fread(image.pixels.data(), 1, image.pixels.size(), file) == image.pixels.size();
+    }
+    std::fclose(file);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Использование: " << argv[0]
+                  << " результат.ppm эталон.ppm [--max-diff N] [--max-bad доля] [--min-psnr дБ]" << std::endl;
+        return 2;
+    }
+
+    int maxDiff = 2;
+    double maxBad = 0.001, minPsnr = 40.0;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--max-diff")
+            maxDiff = std::atoi(argv[i + 1]);
+        else if (arg == "--max-bad")
+            maxBad = std::atof(argv[i + 1]);
+        else if (arg == "--min-psnr")
+            minPsnr = std::atof(argv[i + 1]);
+        else {
+            std::cerr << "Неизвестный параметр: " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    PpmImage result, golden;
+    if (!readPPM(argv[1], result)) {
+        std::cerr << "Не удалось прочитать " << argv[1] << std::endl;
+        return 1;
+    }
+    if (!readPPM(argv[2], golden)) {
+        std::cerr << "Не удалось прочитать эталон " << argv[2] << std::endl;
+        return 1;
+    }
+    if (result.width != golden.width || result.height != golden.height) {
+        std::cerr << "Размер " << result.width << "x" << result.height << " не совпадает с эталоном "
+                  << golden.width << "x" << golden.height << std::endl;
+        return 1;
+    }
+
+    size_t pixelCount = size_t(result.width) * result.height;
+    size_t badPixels = 0;
+    int worstDiff = 0;
+    double squaredError = 0;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        int pixelDiff = 0;
+        for (int c = 0; c < 3; ++c) {
+            int diff = std::abs(int(result.pixels[i * 3 + c]) - int(golden.pixels[i * 3 + c]));
+            pixelDiff = std::max(pixelDiff, diff);
+            squaredError += double(diff) * diff;
+        }
+        worstDiff = std::max(worstDiff, pixelDiff);
+        if (pixelDiff > maxDiff)
+            ++badPixels;
+    }
+
+    double mse = squaredError / (pixelCount * 3);
+    double psnr = mse > 0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : INFINITY;
+    double badFraction = double(badPixels) / pixelCount;
+    bool passed = badFraction <= maxBad && psnr >= minPsnr;
+
+    std::printf("%dx%d: отличающихся пикселей %zu (%.4f%%, допустимо %.4f%%), наибольшее отличие %d, PSNR %.2f дБ (не менее %.2f)\n",
+                result.width, result.height, badPixels, badFraction * 100.0, maxBad * 100.0, worstDiff, psnr, minPsnr);
+    std::printf("%s\n", passed ? "Совпадает с эталоном" : "НЕ совпадает с эталоном");
+    return passed ? 0 : 1;
+}
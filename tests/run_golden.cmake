@@ -0,0 +1,28 @@
+# Эталонный тест: отрисовка кадра и сравнение с эталонным изображением
+#
+# cmake -DRENDER="программа;параметры" [-DCONVERT="программа;параметры"] -DWORKING_DIRECTORY=каталог
+#       -DOUTPUT=результат.ppm -DGOLDEN=эталон.ppm -DCOMPARE=image_compare -DTOLERANCE="--max-diff;2"
+#       -P run_golden.cmake
+#
+# CONVERT выполняется после RENDER (например, raw_to_ppm для вывода KGRAW1).
+# С переменной окружения KG_UPDATE_GOLDEN=1 результат копируется в эталон.
+
+foreach(step RENDER CONVERT)
+    if(DEFINED ${step})
+        execute_process(COMMAND ${${step}} WORKING_DIRECTORY "${WORKING_DIRECTORY}" RESULT_VARIABLE status)
+        if(NOT status EQUAL 0)
+            message(FATAL_ERROR "Ошибка (${status}): ${${step}}")
+        endif()
+    endif()
+endforeach()
+
+if("$ENV{KG_UPDATE_GOLDEN}" STREQUAL "1")
+    configure_file("${OUTPUT}" "${GOLDEN}" COPYONLY)
+    message(STATUS "Эталон обновлён: ${GOLDEN}")
+    return()
+endif()
+
+execute_process(COMMAND "${COMPARE}" "${OUTPUT}" "${GOLDEN}" ${TOLERANCE} RESULT_VARIABLE status)
+if(NOT status EQUAL 0)
+    message(FATAL_ERROR "Изображение ${OUTPUT} не совпадает с эталоном ${GOLDEN}")
+endif()